@@ -0,0 +1,270 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "LevelParser.hpp"
+#include "LifeEngine.hpp"
+#include "CycleDetector.hpp"
+#include "BoardBatch.hpp"
+#include "BoardTripleBuffer.hpp"
+#include "BlockSynth.hpp"
+#include "ThreadPool.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ BENCHMARKS
+ The benchmarks measure the hot paths of the simulation and of the levels' loading, on random square boards from 8 * 8 to 8192 * 8192 cells with a density (alive cells) from 1% to 50%.
+ They use the classes that don't depend on openFrameworks, the same code called by the Environment and by the Game:
+
+    -gameOfLifeEngine => LifeEngine::step() + the cycle detector's check (Environment::gameOfLifeEngine()) of the random board's first generation: the board is loaded again before every op (outside the timer), so it is the step's cost at that density
+    -gameOfLifeEngine_settled => the same, but the generations follow each other from the random board: after a few generations the board settles, and its unchanged tiles are skipped (the cost of a level after a while)
+    -boardBatch => BoardBatch::step() of 1024 copies of the random board (only the sizes up to 64, the solver's and the generator's grids)
+    -countNeighbours_xy, _x, _y => BitBoard::countNeighbours() of 1024 random cells, in the 3 modes of Environment::countNeighbours()
+    -countAliveCells_torus => LifeEngine::countAlive() (1024 calls, it doesn't scan the board)
+    -countAliveCells_plane => BitBoard::countAlive() (the plane's visible area is counted)
+    -soundtrackHandoff => BoardTripleBuffer::write() + read() (the board passed from the game to the audio thread, Soundtrack::setBoard() and play())
+    -soundtrackRender => BlockSynth::render() of a 512 frames stereo buffer (Soundtrack::play(), a voice for every row, 5 harmonics)
+    -levelsParser => LevelParser::parse() of the level's text (Game::levelsParser())
+    -levelChecker => LevelParser::check() (Game::levelChecker())
+
+ Every benchmark is repeated until it runs for at least minTime milliseconds (at least once). The results are written as JSON (on stdout or in a file), one record for every benchmark, size and density:
+
+    {"name": "gameOfLifeEngine", "size": 1024, "density": 0.25, "iterations": 812, "ns_per_op": 61532.1, "items_per_op": 1048576, "ns_per_item": 0.0587}
+
+ An op is one call of the measured code (or one batch of 1024 calls), an item is a cell (or a call of the batch, or a sample of a row for the soundtrack).
+
+ Usage:
+
+    bacteria-benchmarks [-o results.json] [--max-size 8192] [--min-time 50] [-t threads] [--filter name]
+
+ It has no build files of its own: its g++ line is in the README (Building the tools).
+
+ The functions are:
+
+ -main() => it reads the arguments, runs the benchmarks and writes the JSON
+ -randomBoard() => it creates a random board with the passed density
+ -levelText() => it writes a board as a level of levels.txt
+ -measure() => it repeats a benchmark for minTime milliseconds and returns its record
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct BenchmarkOptions{
+    std::string output;                         //empty => stdout
+    int maxSize = 8192;
+    double minTime = 50;                        //milliseconds of every benchmark
+    int threads = 0;
+    std::string filter;                         //only the benchmarks whose name contains it
+};
+
+struct BenchmarkResult{
+    std::string name;
+    int size;
+    double density;
+    long iterations;
+    double nsPerOp;
+    long itemsPerOp;
+};
+
+static const int batchSize = 1024;              //calls of a batch (the functions too fast to be timed one by one)
+static volatile long sink = 0;                  //the results are written here, so the compiler can't remove the measured calls
+
+
+//the same seed for the same size and density: the versions are measured on the same boards
+static BitBoard randomBoard(int size, double density){
+    std::mt19937_64 random(uint64_t(size) * 1000 + uint64_t(density * 1000));
+    std::bernoulli_distribution alive(density);
+    BitBoard board(size, size);
+
+    for(int y=0; y<size; y++){
+        for(int x=0; x<size; x++){
+            if(alive(random)) board.set(x, y, true);
+        }
+    }
+    return board;
+}
+
+static std::string levelText(const BitBoard &board){
+    std::string text = "##delay=240\n";
+    text.reserve(text.size() + size_t(board.getWidth()) * 2 * board.getHeight());
+
+    for(int y=0; y<board.getHeight(); y++){
+        for(int x=0; x<board.getWidth(); x++){
+            text += board.get(x, y) ? '1' : '0';
+            text += x == board.getWidth() - 1 ? '\n' : ',';
+        }
+    }
+    return text;
+}
+
+/*
+ MEASURE
+
+ The benchmark runs once before the timer starts (the caches and the lazy allocations, like the ThreadPool's threads), then it is repeated until minTime is reached.
+ If there is a reset function, it runs before every op and it isn't measured: every op is timed alone.
+*/
+static BenchmarkResult measure(const std::string &name, int size, double density, long itemsPerOp, double minTime, const std::function<void()> &op, const std::function<void()> &reset){
+    if(reset) reset();
+    op();
+
+    long iterations = 0;
+    double elapsed = 0;
+    auto start = std::chrono::steady_clock::now();
+    while(iterations == 0 || elapsed < minTime * 1e6){
+        if(reset){
+            reset();
+            start = std::chrono::steady_clock::now();
+            op();
+            elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        else{
+            op();
+            elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        iterations++;
+    }
+    return {name, size, density, iterations, elapsed / iterations, itemsPerOp};
+}
+
+int main(int argc, char *argv[]){
+    BenchmarkOptions options;
+
+    for(int i=1; i<argc; i++){
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "-o") == 0 && hasValue) options.output = argv[++i];
+        else if(std::strcmp(argv[i], "--max-size") == 0 && hasValue) options.maxSize = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "--min-time") == 0 && hasValue) options.minTime = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "-t") == 0 && hasValue) options.threads = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "--filter") == 0 && hasValue) options.filter = argv[++i];
+        else{
+            std::fprintf(stderr, "usage: %s [-o results.json] [--max-size 8192] [--min-time 50] [-t threads] [--filter name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const int sizes[] = {8, 64, 512, 2048, 8192};
+    const double densities[] = {0.01, 0.05, 0.10, 0.25, 0.50};
+    std::vector<BenchmarkResult> results;
+    ThreadPool threadPool(options.threads);
+
+    for(int size : sizes){
+        if(size > options.maxSize) continue;
+
+        for(double density : densities){
+            BitBoard board = randomBoard(size, density);
+            long cells = long(size) * size;
+            auto run = [&](const std::string &name, long itemsPerOp, const std::function<void()> &op, const std::function<void()> &reset = nullptr){
+                if(name.find(options.filter) == std::string::npos) return;
+                results.push_back(measure(name, size, density, itemsPerOp, options.minTime, op, reset));
+                std::fprintf(stderr, "%-24s %5d %.2f %14.1f ns/op\n", name.c_str(), size, density, results.back().nsPerOp);
+            };
+
+            LifeEngine lifeEngine;
+            CycleDetector cycleDetector;
+            lifeEngine.setThreadCount(options.threads);
+            auto stepEngine = [&](){
+                lifeEngine.step();
+                if(cycleDetector.getPeriod() == 0) cycleDetector.add(lifeEngine.getStats().generation, lifeEngine.getStats().hash);
+            };
+            auto reloadEngine = [&](){
+                lifeEngine.load(board);
+                cycleDetector.reset();
+            };
+            run("gameOfLifeEngine", cells, stepEngine, reloadEngine);
+            reloadEngine();
+            run("gameOfLifeEngine_settled", cells, stepEngine);
+
+            if(size <= BoardBatch::maxWidth){
+                BoardBatch batch(size, size, batchSize);
+                for(int i=0; i<batchSize; i++) batch.load(i, board);
+                run("boardBatch", cells * batchSize, [&](){
+                    batch.step(1, LifeRule::conway(), &threadPool);
+                    sink = batch.getPopulation(0);
+                });
+            }
+
+            //the same random cells for the 3 modes
+            std::mt19937 random(size);
+            std::vector<int> cellsX(batchSize), cellsY(batchSize);
+            for(int i=0; i<batchSize; i++){
+                cellsX[i] = random() % size;
+                cellsY[i] = random() % size;
+            }
+            const char *modes[] = {"xy", "x", "y"};
+            for(const char *mode : modes){
+                bool horizontal = std::strcmp(mode, "y") != 0;
+                bool vertical = std::strcmp(mode, "x") != 0;
+                run(std::string("countNeighbours_") + mode, batchSize, [&](){
+                    long count = 0;
+                    for(int i=0; i<batchSize; i++) count += board.countNeighbours(cellsX[i], cellsY[i], horizontal, vertical);
+                    sink = count;
+                });
+            }
+
+            lifeEngine.load(board);
+            run("countAliveCells_torus", batchSize, [&](){
+                long count = 0;
+                for(int i=0; i<batchSize; i++) count += lifeEngine.countAlive();
+                sink = count;
+            });
+            run("countAliveCells_plane", cells, [&](){
+                sink = board.countAlive();
+            });
+
+            BoardTripleBuffer handoff;
+            handoff.reserve(size, size);
+            run("soundtrackHandoff", cells, [&](){
+                handoff.write(board);
+                handoff.read();
+                sink = handoff.getBoard().get(size-1, size-1);
+            });
+
+            if(options.filter.empty() || std::string("soundtrackRender").find(options.filter) != std::string::npos){
+                const int frames = 512;
+                std::vector<double> frequencies;
+                for(int y=0; y<size; y++) frequencies.push_back(100 * (y % 5 + 1));
+                BlockSynth synth;
+                synth.setup(44100, frequencies, 8);
+                std::vector<float> buffer(frames * 2);
+                run("soundtrackRender", long(frames) * size, [&](){
+                    synth.render(board, buffer.data(), frames, 2);
+                    sink = buffer[frames - 1] > 0;
+                });
+            }
+
+            if(options.filter.empty() || std::string("levelsParser").find(options.filter) != std::string::npos){
+                std::string text = levelText(board);
+                run("levelsParser", cells, [&](){
+                    std::vector<LevelParser::Level> levels = LevelParser::parse(text.data(), text.size());
+                    sink = levels[0].board.getWidth();
+                });
+            }
+
+            run("levelChecker", cells, [&](){
+                sink = LevelParser::check(board).size();
+            });
+        }
+    }
+
+    FILE *file = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "w");
+    if(!file){
+        std::fprintf(stderr, "The file %s can't be written\n", options.output.c_str());
+        return 1;
+    }
+
+    std::fprintf(file, "{\n  \"benchmarks\": \"bacteria\",\n  \"min_time_ms\": %g,\n  \"threads\": %d,\n  \"results\": [\n", options.minTime, options.threads);
+    for(size_t r=0; r<results.size(); r++){
+        const BenchmarkResult &result = results[r];
+        std::fprintf(file, "    {\"name\": \"%s\", \"size\": %d, \"density\": %.2f, \"iterations\": %ld, \"ns_per_op\": %.1f, \"items_per_op\": %ld, \"ns_per_item\": %.4f}%s\n",
+                     result.name.c_str(), result.size, result.density, result.iterations, result.nsPerOp, result.itemsPerOp,
+                     result.nsPerOp / result.itemsPerOp, r + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    if(file != stdout) std::fclose(file);
+    return 0;
+}
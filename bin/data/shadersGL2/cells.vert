@@ -0,0 +1,26 @@
+#version 120
+#extension GL_ARB_draw_instanced : require
+
+// instanced grid: one instance for every cell, the position is computed from gl_InstanceIDARB (instances are ordered column by column)
+uniform int gridHeight;
+uniform float spacing;
+uniform float depth;
+uniform vec4 deadColor;
+uniform vec4 aliveColor;
+
+attribute float alive;  // per-instance attribute: 1.0 alive, 0.0 dead
+
+varying vec4 cellColor;
+
+void main(){
+    int x = gl_InstanceIDARB / gridHeight;
+    int y = gl_InstanceIDARB - x * gridHeight;
+    vec4 cellPos = gl_Vertex + vec4(float(x) * spacing, float(y) * spacing, depth, 0.0);
+
+    // a cheap directional shading, so the boxes' sides are still visible
+    float light = 0.6 + 0.4 * abs(gl_Normal.z);
+    cellColor = mix(deadColor, aliveColor, alive);
+    cellColor.rgb *= light;
+
+    gl_Position = gl_ModelViewProjectionMatrix * cellPos;
+}
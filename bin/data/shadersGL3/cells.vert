@@ -0,0 +1,28 @@
+#version 150
+
+// instanced grid: one instance for every cell, the position is computed from gl_InstanceID (instances are ordered column by column)
+uniform mat4 modelViewProjectionMatrix;
+uniform int gridHeight;
+uniform float spacing;
+uniform float depth;
+uniform vec4 deadColor;
+uniform vec4 aliveColor;
+
+in vec4 position;
+in vec3 normal;
+in float alive;         // per-instance attribute: 1.0 alive, 0.0 dead
+
+out vec4 cellColor;
+
+void main(){
+    int x = gl_InstanceID / gridHeight;
+    int y = gl_InstanceID - x * gridHeight;
+    vec4 cellPos = position + vec4(float(x) * spacing, float(y) * spacing, depth, 0.0);
+
+    // a cheap directional shading, so the boxes' sides are still visible
+    float light = 0.6 + 0.4 * abs(normal.z);
+    cellColor = mix(deadColor, aliveColor, alive);
+    cellColor.rgb *= light;
+
+    gl_Position = modelViewProjectionMatrix * cellPos;
+}
@@ -0,0 +1,162 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "LevelGenerator.hpp"
+#include "LevelSolver.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ GENERATOR
+ The generator is a command line program that creates new levels for levels.txt (see LevelGenerator): it screens random and symmetric grids by simulating them, and it writes the most difficult ones.
+ It uses only the classes that don't depend on openFrameworks.
+
+ The levels are written in the format of levels.txt (on stdout or in a file), ready to be appended to it:
+
+    ##delay=240
+    0,0,1,0,0,1,0,0
+    ...
+
+ The statistics of the screening and the metrics of every level (in order of difficulty) are printed on stderr:
+
+    candidates=100000 extinct=61520 exploded=0 stable=30112 accepted=8368 ms=2803.1 per_minute=2140484
+    rank=0 candidate=51723 symmetry=x lifetime=143 period=2 active=40 population=14 difficulty=5720 solved=yes
+    rank=1 candidate=8812 symmetry=none lifetime=>=4096 period=0 active=64 population=17 difficulty=262144 solved=yes
+
+ The lifetime ">=n" is capped: the grid didn't repeat itself within -L generations.
+
+ With -c every level is checked with the LevelSolver (with its default limits), and only the levels that can be won are written.
+
+ Usage:
+
+    bacteria-generator [-o levels.txt] [-W width] [-H height] [-n candidates] [-d density] [-y symmetry] [-g generations] [-L generations] [-m lifetime] [-x density] [-k levels] [-D delay] [-r rule] [-s seed] [-t threads] [-c]
+
+    -o => the output file (stdout by default)
+    -W, -H => the levels' size (8 * 8 by default, at most 64 columns)
+    -n => the candidates screened (100000 by default)
+    -d => the alive cells of a random grid (0.25 by default)
+    -y => the symmetry: none, x, y, xy, rotation or any (a random symmetry for every candidate, the default)
+    -g => the generations simulated in the batches (256 by default)
+    -L => the max generations of the grids still running after -g generations, simulated one by one (4096 by default)
+    -m => the min lifetime: the grids that repeat themselves earlier are rejected (16 by default)
+    -x => the max density: the grids with more alive cells explode (0.5 by default)
+    -k => the levels written (10 by default)
+    -D => the levels' delay (240 by default)
+    -r => the rule (B3/S23 by default)
+    -s => the random seed (1 by default)
+    -t => the threads (0 => one for each CPU core, the default)
+    -c => only the levels that the LevelSolver can win are written
+
+ It has no build files of its own: its g++ line is in the README (Building the tools).
+
+ The exit code is 0 if at least one level has been written.
+
+ The functions are:
+
+ -main() => it reads the arguments, generates the levels and writes them
+ -parseSymmetry() => it returns the symmetry of a name (-1 => any, -2 => not valid)
+ -levelText() => it writes a level in the format of levels.txt
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct ToolOptions{
+    std::string output;                         //empty => stdout
+    int delay = 240;
+    bool check = false;
+    GeneratorOptions generator;
+};
+
+
+static int parseSymmetry(const char *name){
+    if(std::strcmp(name, "any") == 0) return -1;
+    for(int s=0; s<LevelGenerator::SYMMETRIES; s++){
+        if(std::strcmp(name, LevelGenerator::symmetryName(LevelGenerator::Symmetry(s))) == 0) return s;
+    }
+    return -2;
+}
+
+static std::string levelText(const BitBoard &board, int delay, const LifeRule &rule){
+    std::string text = "##delay=" + std::to_string(delay);
+    if(rule != LifeRule::conway()) text += " rule=" + rule.toString();
+    text += '\n';
+
+    for(int y=0; y<board.getHeight(); y++){
+        for(int x=0; x<board.getWidth(); x++){
+            text += board.get(x, y) ? '1' : '0';
+            text += x == board.getWidth() - 1 ? '\n' : ',';
+        }
+    }
+    return text;
+}
+
+int main(int argc, char *argv[]){
+    ToolOptions options;
+    bool valid = true;
+
+    for(int i=1; i<argc && valid; i++){
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "-o") == 0 && hasValue) options.output = argv[++i];
+        else if(std::strcmp(argv[i], "-W") == 0 && hasValue) options.generator.width = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-H") == 0 && hasValue) options.generator.height = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-n") == 0 && hasValue) options.generator.candidates = std::atol(argv[++i]);
+        else if(std::strcmp(argv[i], "-d") == 0 && hasValue) options.generator.density = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "-y") == 0 && hasValue) valid = (options.generator.symmetry = parseSymmetry(argv[++i])) != -2;
+        else if(std::strcmp(argv[i], "-g") == 0 && hasValue) options.generator.generations = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-L") == 0 && hasValue) options.generator.maxLifetime = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-m") == 0 && hasValue) options.generator.minLifetime = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-x") == 0 && hasValue) options.generator.maxDensity = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "-k") == 0 && hasValue) options.generator.keep = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-D") == 0 && hasValue) options.delay = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-r") == 0 && hasValue) valid = LifeRule::parse(argv[++i], options.generator.rule);
+        else if(std::strcmp(argv[i], "-s") == 0 && hasValue) options.generator.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if(std::strcmp(argv[i], "-t") == 0 && hasValue) options.generator.threads = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-c") == 0) options.check = true;
+        else valid = false;
+    }
+    if(!valid || options.generator.width < 1 || options.generator.width > BoardBatch::maxWidth || options.generator.height < 2){
+        std::fprintf(stderr, "usage: %s [-o levels.txt] [-W width] [-H height] [-n candidates] [-d density] [-y symmetry] [-g generations] [-L generations] [-m lifetime] [-x density] [-k levels] [-D delay] [-r rule] [-s seed] [-t threads] [-c]\n", argv[0]);
+        return 2;
+    }
+
+    //the levels that the solver can't win are skipped: more levels are generated
+    int keep = options.generator.keep;
+    if(options.check) options.generator.keep *= 4;
+
+    LevelGenerator generator(options.generator);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<LevelGenerator::Level> levels = generator.generate();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const LevelGenerator::Stats &stats = generator.getStats();
+    std::fprintf(stderr, "candidates=%ld extinct=%ld exploded=%ld stable=%ld accepted=%ld ms=%.1f per_minute=%.0f\n",
+                 stats.screened, stats.extinct, stats.exploded, stats.stable, stats.accepted, ms, ms > 0 ? stats.screened * 60000.0 / ms : 0.0);
+
+    FILE *file = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "w");
+    if(!file){
+        std::fprintf(stderr, "The file %s can't be written\n", options.output.c_str());
+        return 1;
+    }
+
+    int written = 0;
+    for(size_t rank=0; rank<levels.size() && written<keep; rank++){
+        const LevelGenerator::Level &level = levels[rank];
+
+        bool solved = false;
+        if(options.check){
+            LevelSolver solver;
+            solved = solver.solve(level.board, options.generator.rule, options.delay).solved;
+        }
+        std::fprintf(stderr, "rank=%zu candidate=%ld symmetry=%s lifetime=%s%d period=%d active=%d population=%d difficulty=%.0f solved=%s\n",
+                     rank, level.index, LevelGenerator::symmetryName(level.symmetry), level.capped ? ">=" : "", level.lifetime, level.period, level.activeCells,
+                     level.population, level.difficulty, options.check ? (solved ? "yes" : "no") : "unchecked");
+        if(options.check && !solved) continue;
+
+        std::fprintf(file, "%s%s", written > 0 ? "\n\n" : "", levelText(level.board, options.delay, options.generator.rule).c_str());
+        written++;
+    }
+    if(file != stdout) std::fclose(file);
+    return written > 0 ? 0 : 1;
+}
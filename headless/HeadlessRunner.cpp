@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "LevelParser.hpp"
+#include "LifeEngine.hpp"
+#include "SparseLifeEngine.hpp"
+#include "HashLifeEngine.hpp"
+#include "CycleDetector.hpp"
+#include "BoardBatch.hpp"
+#include "ThreadPool.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ HEADLESSRUNNER
+ The headless runner is a command line program that runs the game's simulation without a window, without GL and without audio: it can profile and regression-test the levels on a server.
+ It uses only the classes of the simulation that don't depend on openFrameworks (LevelParser, LifeEngine, SparseLifeEngine, HashLifeEngine, CycleDetector), the same ones used by the Environment, and BoardBatch (-b).
+
+ Every level of the file is advanced N generations as fast as possible (there isn't the Game's delay), like Environment::gameOfLifeEngine() does:
+    -torus levels => LifeEngine, with the cycle detection (a periodic grid is replayed from the cache)
+    -plane levels => SparseLifeEngine
+
+ For every level it prints one line with the size, the rule, the time, the final population and the final Zobrist hash (the same hash for the same level and generations, on every machine and with any number of threads):
+
+    level=0 size=5x5 board=torus rule=B3/S23 generations=1000 ms=0.021 us/gen=0.021 population=4 hash=0x1f2e... period=1
+
+ The die-out check (-d) tells offline if a level dies out within n generations, without computing them one by one: HashLife jumps 1, 1, 2, 4, 8... generations (one jump each), and the population is checked after every jump.
+ The first dead checkpoint is dead_by, the last alive one is alive_at: the level dies out in (alive_at, dead_by]. A dead level stays dead.
+    -power of 2 torus levels and plane levels => HashLife is exact (see HashLifeEngine), so n can be huge (2^40 generations take milliseconds)
+    -the other torus levels => LifeEngine, generation by generation, until the grid dies or becomes periodic (a periodic grid never dies)
+ With -S the torus levels are placed in the corner of a size x size torus (a power of 2): a large sparse level (e.g. -S 65536, 4 billion cells) is loaded only in HashLife's nodes, the big board is never allocated.
+
+    level=2 size=8x8 board=torus engine=hashlife limit=1099511627776 dies=yes alive_at=4 dead_by=8 population=0 nodes=1234 ms=0.210
+
+ The BoardBatch check (-b) compares BoardBatch (the solver's and the generator's batches) with BitBoard::nextGeneration() on n random batches: random sizes (up to 64 columns, so the fields of a word change), counts, rules and generations, with and without a ThreadPool.
+ Every board, every row, get() and getPopulation() must match. It prints the number of mismatches (and the first one):
+
+    boardbatch trials=200 mismatches=0 ms=2047.7
+
+ Usage:
+
+    bacteria-headless [levels.txt] [-g generations] [-l level] [-t threads] [--no-cycles] [-d generations] [-S size] [-b trials]
+
+    -levels.txt => the levels file (bin/data/levels.txt by default)
+    -g => the generations of every level (1000 by default)
+    -l => only this level (all the levels by default)
+    -t => LifeEngine's threads (0 => one for each CPU core, the default; 1 => serial)
+    --no-cycles => the periodic grids are computed anyway (the raw speed of the generation step)
+    -d => the die-out check within n generations, instead of the normal run
+    -S => (die-out check) the size of the torus that contains every torus level, a power of 2 (0 => the level's size, the default)
+    -b => the BoardBatch check with n random batches, instead of the levels
+
+ It has no build files of its own: its g++ line is in the README (Building the tools).
+
+ The functions are:
+
+ -main() => it reads the arguments and the levels file, then it runs the levels
+ -runLevel() => it advances a level and prints its line, it returns false if the level is not valid
+ -checkDieOut() => it checks if a level dies out within n generations and prints its line, it returns false if the level is not valid
+ -checkBoardBatch() => it compares random batches with their boards stepped one by one, it returns the mismatches
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct RunnerOptions{
+    std::string path = "bin/data/levels.txt";
+    long generations = 1000;
+    int level = -1;                             //-1 => all the levels
+    int threads = 0;
+    bool cycles = true;
+    long dieOutGenerations = 0;                 //0 => the normal run
+    int size = 0;                               //0 => the level's size (die-out check only)
+    int batchTrials = 0;                        //0 => the levels are run
+};
+
+
+/*
+ RUNLEVEL
+
+ The timer measures only the generations (not the level's loading). The cycle detection is part of the measure: the Environment does it after every generation too.
+*/
+static bool runLevel(int index, const LevelParser::Level &level, const RunnerOptions &options){
+    for(const std::string &error : level.errors) std::fprintf(stderr, "level %d: %s\n", index, error.c_str());
+
+    std::string error = LevelParser::check(level.board);           //the same checks of Game::levelChecker()
+    if(!error.empty()){
+        std::fprintf(stderr, "level %d: %s (skipped)\n", index, error.c_str());
+        return false;
+    }
+
+    LifeEngine lifeEngine;
+    SparseLifeEngine sparseEngine;
+    CycleDetector cycleDetector;
+    LifeBackend &engine = level.plane ? static_cast<LifeBackend &>(sparseEngine) : static_cast<LifeBackend &>(lifeEngine);
+    auto getStats = [&]() -> const GenerationStats & { return level.plane ? sparseEngine.getStats() : lifeEngine.getStats(); };
+
+    lifeEngine.setThreadCount(options.threads);
+    engine.load(level.board);
+    engine.setRule(level.rule);
+    if(options.cycles) cycleDetector.add(getStats().generation, getStats().hash);
+
+    auto start = std::chrono::steady_clock::now();
+    for(long g=0; g<options.generations; g++){
+        engine.step();
+
+        if(options.cycles && cycleDetector.getPeriod() == 0){
+            int period = cycleDetector.add(getStats().generation, getStats().hash);
+            if(period > 0 && !level.plane) lifeEngine.cacheCycle(period);
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const GenerationStats &stats = getStats();
+    std::printf("level=%d size=%dx%d board=%s rule=%s generations=%ld ms=%.3f us/gen=%.3f population=%ld hash=0x%016llx period=%d\n",
+                index, level.board.getWidth(), level.board.getHeight(), level.plane ? "plane" : "torus", level.rule.toString().c_str(),
+                stats.generation, ms, options.generations > 0 ? ms * 1000.0 / options.generations : 0.0,
+                stats.population, (unsigned long long)stats.hash, cycleDetector.getPeriod());
+    return true;
+}
+
+/*
+ CHECKDIEOUT
+
+ HashLife is used only where it gives the game's result: the plane levels (setPlaneMode()) and the power of 2 torus levels. The checkpoints are powers of 2, so every advance() is a single jump.
+*/
+static bool checkDieOut(int index, const LevelParser::Level &level, const RunnerOptions &options){
+    std::string error = LevelParser::check(level.board);
+    if(!error.empty()){
+        std::fprintf(stderr, "level %d: %s (skipped)\n", index, error.c_str());
+        return false;
+    }
+
+    HashLifeEngine hashLife;
+    hashLife.setPlaneMode(level.plane);
+    hashLife.setRule(level.rule);
+    bool scaled = options.size > 0 && !level.plane;              //the plane is unbounded: its size doesn't change
+    if(scaled) hashLife.load(level.board, options.size, options.size);
+    else hashLife.load(level.board);
+    bool exact = level.plane || hashLife.isTorus();
+
+    long aliveAt = 0, deadBy = -1, population = hashLife.countAlive();
+    int period = 0;
+    auto start = std::chrono::steady_clock::now();
+    if(exact){
+        for(long generation=0; population > 0 && generation < options.dieOutGenerations; ){
+            long jump = std::min(generation > 0 ? generation : 1, options.dieOutGenerations - generation);
+            hashLife.advance(jump);
+            generation += jump;
+            population = hashLife.countAlive();
+            if(population > 0) aliveAt = generation;
+            else deadBy = generation;
+        }
+    }
+    else{
+        LifeEngine lifeEngine;
+        CycleDetector cycleDetector;
+        lifeEngine.load(level.board);
+        lifeEngine.setRule(level.rule);
+        cycleDetector.add(0, lifeEngine.getStats().hash);
+        for(long generation=1; population > 0 && period == 0 && generation <= options.dieOutGenerations; generation++){
+            lifeEngine.step();
+            population = lifeEngine.getStats().population;
+            if(population > 0) aliveAt = generation;
+            else deadBy = generation;
+            period = cycleDetector.add(generation, lifeEngine.getStats().hash);
+        }
+    }
+    if(population == 0 && deadBy < 0) deadBy = 0;                  //an empty level
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int width = scaled ? std::max(options.size, level.board.getWidth()) : level.board.getWidth();
+    int height = scaled ? std::max(options.size, level.board.getHeight()) : level.board.getHeight();
+    std::printf("level=%d size=%dx%d board=%s engine=%s limit=%ld dies=%s alive_at=%ld dead_by=%ld population=%ld period=%d nodes=%zu ms=%.3f\n",
+                index, width, height, level.plane ? "plane" : "torus", exact ? "hashlife" : "lifeengine",
+                options.dieOutGenerations, population == 0 ? "yes" : period > 0 ? "never" : "no", aliveAt, deadBy, population, period,
+                exact ? hashLife.getNodeCount() : size_t(0), ms);
+    return true;
+}
+
+/*
+ CHECKBOARDBATCH
+
+ Every trial has a random size (1 to maxWidth columns, so the fields of a word change), a random number of boards (the last lane is partly empty), a random rule and random generations.
+ Some cells are changed with set() between the steps: the reference boards get the same changes.
+*/
+static long checkBoardBatch(int trials, ThreadPool &threadPool){
+    const char *rules[] = {"B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B1/S012345678"};
+    std::mt19937_64 random(2024);
+    long mismatches = 0;
+
+    for(int trial=0; trial<trials; trial++){
+        int width = 1 + int(random() % BoardBatch::maxWidth);
+        int height = 1 + int(random() % 64);
+        int count = 1 + int(random() % 300);
+        LifeRule rule;
+        LifeRule::parse(rules[random() % 5], rule);
+        std::bernoulli_distribution alive(0.05 + (random() % 50) / 100.0);
+
+        BoardBatch batch(width, height, count);
+        std::vector<BitBoard> boards(count, BitBoard(width, height));
+        for(int i=0; i<count; i++){
+            for(int y=0; y<height; y++){
+                for(int x=0; x<width; x++) boards[i].set(x, y, alive(random));
+            }
+            batch.load(i, boards[i]);
+        }
+
+        BitBoard next(width, height);
+        for(int round=0; round<3; round++){
+            int generations = 1 + int(random() % 8);
+            batch.step(generations, rule, trial % 2 ? &threadPool : nullptr);
+            for(BitBoard &board : boards){
+                for(int g=0; g<generations; g++){
+                    board.nextGeneration(next, rule);
+                    std::swap(board, next);
+                }
+            }
+
+            for(int i=0; i<count; i++){
+                bool same = batch.getPopulation(i) == boards[i].countAlive();
+                for(int y=0; y<height && same; y++){
+                    same = batch.getRow(i, y) == boards[i].getRow(y)[0];
+                    int x = int(random() % width);
+                    same = same && batch.get(i, x, y) == boards[i].get(x, y);
+                }
+                if(!same){
+                    if(mismatches == 0) std::fprintf(stderr, "boardBatch mismatch: size=%dx%d count=%d board=%d rule=%s round=%d\n", width, height, count, i, rule.toString().c_str(), round);
+                    mismatches++;
+                }
+            }
+
+            for(int c=0; c<count; c++){
+                int i = int(random() % count), x = int(random() % width), y = int(random() % height);
+                bool state = random() % 2;
+                batch.set(i, x, y, state);
+                boards[i].set(x, y, state);
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main(int argc, char *argv[]){
+    RunnerOptions options;
+
+    for(int i=1; i<argc; i++){
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "-g") == 0 && hasValue) options.generations = std::atol(argv[++i]);
+        else if(std::strcmp(argv[i], "-l") == 0 && hasValue) options.level = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-t") == 0 && hasValue) options.threads = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "--no-cycles") == 0) options.cycles = false;
+        else if(std::strcmp(argv[i], "-d") == 0 && hasValue) options.dieOutGenerations = std::atol(argv[++i]);
+        else if(std::strcmp(argv[i], "-S") == 0 && hasValue) options.size = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-b") == 0 && hasValue) options.batchTrials = std::atoi(argv[++i]);
+        else if(argv[i][0] != '-') options.path = argv[i];
+        else{
+            std::fprintf(stderr, "usage: %s [levels.txt] [-g generations] [-l level] [-t threads] [--no-cycles] [-d generations] [-S size] [-b trials]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(options.size < 0 || options.size > (1 << 30) || (options.size & (options.size - 1)) != 0){
+        std::fprintf(stderr, "The size (-S) must be a power of 2 (at most 2^30)\n");
+        return 2;
+    }
+
+    if(options.batchTrials > 0){
+        ThreadPool threadPool(options.threads);
+        auto start = std::chrono::steady_clock::now();
+        long mismatches = checkBoardBatch(options.batchTrials, threadPool);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("boardbatch trials=%d mismatches=%ld ms=%.1f\n", options.batchTrials, mismatches, ms);
+        return mismatches > 0 ? 1 : 0;
+    }
+
+    std::vector<LevelParser::Level> levels;
+    auto start = std::chrono::steady_clock::now();
+    if(!LevelParser::parseFile(options.path, levels)){
+        std::fprintf(stderr, "The file %s can't be read\n", options.path.c_str());
+        return 1;
+    }
+    double parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("file=%s levels=%zu parse_ms=%.3f\n", options.path.c_str(), levels.size(), parseMs);
+
+    if(options.level >= int(levels.size())){
+        std::fprintf(stderr, "The file has only %zu levels\n", levels.size());
+        return 1;
+    }
+
+    bool allValid = true;
+    for(int l=0; l<int(levels.size()); l++){
+        if(options.level >= 0 && l != options.level) continue;
+        bool valid = options.dieOutGenerations > 0 ? checkDieOut(l, levels[l], options) : runLevel(l, levels[l], options);
+        if(!valid) allValid = false;
+    }
+    return allValid ? 0 : 1;
+}
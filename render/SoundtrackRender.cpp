@@ -0,0 +1,205 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "LevelParser.hpp"
+#include "LifeEngine.hpp"
+#include "SparseLifeEngine.hpp"
+#include "BlockSynth.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ SOUNDTRACKRENDER
+ The soundtrack render is a command line program that writes the soundtrack of a level's evolution in a WAV file, without a window and without a sound device, as fast as the CPU allows (the audio regression tests and the trailers).
+ It uses only the classes that don't depend on openFrameworks: the level evolves with the LifeEngine (or the SparseLifeEngine for the plane levels), and it is played by the same keyboard of the Soundtrack (BlockSynth::setupKeyboard(): the beatsPerSecond column sweep and the harmonic keyboard, with the Soundtrack's KeyboardOptions).
+
+ The timing is the game's one, without the player:
+    -a generation every delay frames of the game (the level's delay at 60 frames a second, so 240 => a generation every 4 seconds)
+    -the audio is rendered in buffers of bufferSize frames (the ofApp's sound stream), and every buffer plays the last generation computed before it (like Soundtrack::play() with the BoardTripleBuffer)
+ The level keeps evolving until the end, also after it dies out (the soundtrack becomes silent).
+
+ The WAV file is 16 bit PCM stereo. The program prints one line with the render's time and the hash of the samples (FNV-1a of the PCM data: the same level and options give the same hash on every machine):
+
+    level=0 size=20x20 seconds=600.0 frames=26460000 generations=150 ms=2105.3 realtime=285.0x hash=0x8d1f... file=soundtrack.wav
+
+ Usage:
+
+    bacteria-render [levels.txt] [-l level] [-o soundtrack.wav] [-s seconds] [-r sampleRate] [-b bufferSize] [-f frameRate] [-D delay] [-v voices]
+
+    -levels.txt => the levels file (bin/data/levels.txt by default)
+    -l => the level (0 by default)
+    -o => the WAV file (soundtrack.wav by default)
+    -s => the seconds of soundtrack (60 by default)
+    -r => the sample rate (44100 by default)
+    -b => the frames of every audio buffer (512 by default)
+    -f => the game's frames a second (60 by default)
+    -D => the frames between two generations (the level's delay by default)
+    -v => the max harmonics played at once (8 by default, 0 => no limit)
+
+ It has no build files of its own: its g++ line is in the README (Building the tools).
+
+ The functions are:
+
+ -main() => it reads the arguments and the level, then it renders the soundtrack
+ -writeWavHeader() => it writes the header of a 16 bit PCM WAV file (little endian)
+ -toPcm() => it converts the rendered samples to 16 bit PCM and updates the hash
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct RenderOptions{
+    std::string path = "bin/data/levels.txt";
+    std::string output = "soundtrack.wav";
+    int level = 0;
+    double seconds = 60;
+    int sampleRate = 44100;                     //ofApp::sampleRate
+    int bufferSize = 512;                       //ofApp::bufferSize
+    int frameRate = 60;                         //ofApp::frameRate
+    int delay = 0;                              //0 => the level's delay
+    KeyboardOptions keyboard;
+};
+
+
+static void writeWavHeader(FILE *file, int sampleRate, int channels, uint32_t dataBytes){
+    auto write16 = [file](uint16_t value){
+        uint8_t bytes[2] = {uint8_t(value), uint8_t(value >> 8)};
+        std::fwrite(bytes, 1, 2, file);
+    };
+    auto write32 = [file](uint32_t value){
+        uint8_t bytes[4] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+        std::fwrite(bytes, 1, 4, file);
+    };
+
+    std::fwrite("RIFF", 1, 4, file);
+    write32(36 + dataBytes);
+    std::fwrite("WAVEfmt ", 1, 8, file);
+    write32(16);                                //the fmt chunk's size
+    write16(1);                                 //PCM
+    write16(uint16_t(channels));
+    write32(uint32_t(sampleRate));
+    write32(uint32_t(sampleRate * channels * 2));
+    write16(uint16_t(channels * 2));
+    write16(16);
+    std::fwrite("data", 1, 4, file);
+    write32(dataBytes);
+}
+
+//the samples are clipped to [-1, 1], the bytes are little endian on every machine
+static void toPcm(const float *samples, size_t count, std::vector<uint8_t> &pcm, uint64_t &hash){
+    pcm.resize(count * 2);
+    for(size_t i=0; i<count; i++){
+        float sample = samples[i] < -1.0f ? -1.0f : samples[i] > 1.0f ? 1.0f : samples[i];
+        int16_t value = int16_t(sample * 32767.0f);
+        pcm[i * 2] = uint8_t(uint16_t(value));
+        pcm[i * 2 + 1] = uint8_t(uint16_t(value) >> 8);
+    }
+    for(uint8_t byte : pcm){
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+}
+
+int main(int argc, char *argv[]){
+    RenderOptions options;
+
+    for(int i=1; i<argc; i++){
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "-l") == 0 && hasValue) options.level = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-o") == 0 && hasValue) options.output = argv[++i];
+        else if(std::strcmp(argv[i], "-s") == 0 && hasValue) options.seconds = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "-r") == 0 && hasValue) options.sampleRate = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-b") == 0 && hasValue) options.bufferSize = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-f") == 0 && hasValue) options.frameRate = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-D") == 0 && hasValue) options.delay = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-v") == 0 && hasValue) options.keyboard.voiceLimit = std::atoi(argv[++i]);
+        else if(argv[i][0] != '-') options.path = argv[i];
+        else{
+            options.sampleRate = 0;
+            break;
+        }
+    }
+    if(options.sampleRate <= 0 || options.bufferSize <= 0 || options.frameRate <= 0 || options.seconds < 0 || options.delay < 0){
+        std::fprintf(stderr, "usage: %s [levels.txt] [-l level] [-o soundtrack.wav] [-s seconds] [-r sampleRate] [-b bufferSize] [-f frameRate] [-D delay] [-v voices]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<LevelParser::Level> levels;
+    if(!LevelParser::parseFile(options.path, levels)){
+        std::fprintf(stderr, "The file %s can't be read\n", options.path.c_str());
+        return 1;
+    }
+    if(options.level < 0 || options.level >= int(levels.size())){
+        std::fprintf(stderr, "The file has only %zu levels\n", levels.size());
+        return 1;
+    }
+    const LevelParser::Level &level = levels[options.level];
+    std::string error = LevelParser::check(level.board);           //the same checks of Game::levelChecker()
+    if(!error.empty()){
+        std::fprintf(stderr, "level %d: %s\n", options.level, error.c_str());
+        return 1;
+    }
+
+    const int channels = 2;
+    const long frames = long(options.seconds * options.sampleRate);
+    const uint64_t dataBytes = uint64_t(frames) * channels * 2;
+    if(dataBytes > 0xffffffffull - 36){
+        std::fprintf(stderr, "%.1f seconds don't fit in a WAV file\n", options.seconds);
+        return 1;
+    }
+    FILE *file = std::fopen(options.output.c_str(), "wb");
+    if(!file){
+        std::fprintf(stderr, "The file %s can't be written\n", options.output.c_str());
+        return 1;
+    }
+    writeWavHeader(file, options.sampleRate, channels, uint32_t(dataBytes));
+
+    LifeEngine lifeEngine;
+    SparseLifeEngine sparseEngine;
+    LifeBackend &engine = level.plane ? static_cast<LifeBackend &>(sparseEngine) : static_cast<LifeBackend &>(lifeEngine);
+    engine.load(level.board);
+    engine.setRule(level.rule);
+    BitBoard board = level.board;
+
+    BlockSynth synth;
+    synth.setupKeyboard(options.sampleRate, board.getHeight(), options.keyboard);
+
+    //a generation every delay game's frames, in audio frames
+    const double generationFrames = double(options.delay > 0 ? options.delay : level.delay) / options.frameRate * options.sampleRate;
+    double nextGeneration = generationFrames;
+    long generations = 0;
+
+    std::vector<float> buffer(size_t(options.bufferSize) * channels);
+    std::vector<uint8_t> pcm;
+    uint64_t hash = 14695981039346656037ull;
+
+    auto start = std::chrono::steady_clock::now();
+    for(long frame=0; frame<frames; frame+=options.bufferSize){
+        while(frame >= nextGeneration){
+            engine.step();
+            engine.copyTo(board);
+            generations++;
+            nextGeneration += generationFrames;
+        }
+
+        int count = int(std::min(long(options.bufferSize), frames - frame));
+        synth.render(board, buffer.data(), count, channels);
+        toPcm(buffer.data(), size_t(count) * channels, pcm, hash);
+        std::fwrite(pcm.data(), 1, pcm.size(), file);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    bool written = std::ferror(file) == 0;
+    if(std::fclose(file) != 0) written = false;
+    if(!written){
+        std::fprintf(stderr, "The file %s can't be written\n", options.output.c_str());
+        return 1;
+    }
+
+    std::printf("level=%d size=%dx%d seconds=%.1f frames=%ld generations=%ld ms=%.1f realtime=%.1fx hash=0x%016llx file=%s\n",
+                options.level, board.getWidth(), board.getHeight(), options.seconds, frames, generations, ms,
+                ms > 0 ? options.seconds * 1000.0 / ms : 0.0, (unsigned long long)hash, options.output.c_str());
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "LevelParser.hpp"
+#include "LevelSolver.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ SOLVER
+ The solver is a command line program that searches how to win every level of levels.txt (see LevelSolver), to check that a new level can be won before it is added to the game.
+ It uses only the classes that don't depend on openFrameworks: the keys are found and checked with the GameModel, the same rules of the Game.
+
+ For every level it prints one line with the result, and with -v the keys of the solution (the frame of every key, the first frame of the level is 0):
+
+    level=4 size=5x5 delay=240 solved=yes generations=2 shots=2 frames=719 states=151 ms=37.423
+    level=4 frame=0 key=LEFT
+    level=4 frame=17 key=RIGHT
+    ...
+
+ Only the torus levels can be solved (the plane levels have no walls, the rockets never become cells).
+
+ Usage:
+
+    bacteria-solver [levels.txt] [-l level] [-g generations] [-b beam] [-s shots] [-t threads] [-v]
+
+    -levels.txt => the levels file (bin/data/levels.txt by default)
+    -l => only this level (all the levels by default)
+    -g => the max generations of a solution (64 by default)
+    -b => the states kept after every generation (the beam, 512 by default)
+    -s => the max rockets fired between two generations (2 by default)
+    -t => the search's threads (0 => one for each CPU core, the default)
+    -v => it prints the keys of the solutions
+
+ It has no build files of its own: its g++ line is in the README (Building the tools).
+
+ The exit code is 0 if all the levels have been solved.
+
+ The functions are:
+
+ -main() => it reads the arguments and the levels file, then it solves the levels
+ -solveLevel() => it solves a level and prints its lines, it returns false if the level is not valid or not solved
+ -keyName() => it returns the name of a key
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct ToolOptions{
+    std::string path = "bin/data/levels.txt";
+    int level = -1;                             //-1 => all the levels
+    bool verbose = false;
+    SolverOptions solver;
+};
+
+
+static const char *keyName(GameModel::Key key){
+    switch(key){
+        case GameModel::UP: return "UP";
+        case GameModel::LEFT: return "LEFT";
+        case GameModel::RIGHT: return "RIGHT";
+        default: return "SPACE";
+    }
+}
+
+static bool solveLevel(int index, const LevelParser::Level &level, const ToolOptions &options){
+    for(const std::string &error : level.errors) std::fprintf(stderr, "level %d: %s\n", index, error.c_str());
+
+    std::string error = LevelParser::check(level.board);           //the same checks of Game::levelChecker()
+    if(!error.empty()){
+        std::fprintf(stderr, "level %d: %s (skipped)\n", index, error.c_str());
+        return false;
+    }
+    if(level.plane){
+        std::fprintf(stderr, "level %d: plane levels can't be solved (skipped)\n", index);
+        return false;
+    }
+
+    LevelSolver solver(options.solver);
+    auto start = std::chrono::steady_clock::now();
+    LevelSolver::Solution solution = solver.solve(level.board, level.rule, level.delay);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("level=%d size=%dx%d delay=%d solved=%s generations=%d shots=%d frames=%ld states=%ld ms=%.3f\n",
+                index, level.board.getWidth(), level.board.getHeight(), level.delay, solution.solved ? "yes" : "no",
+                solution.generations, solution.shots, solution.frames, solution.states, ms);
+    if(options.verbose){
+        for(const LevelSolver::Input &input : solution.inputs) std::printf("level=%d frame=%ld key=%s\n", index, input.frame, keyName(input.key));
+    }
+    return solution.solved;
+}
+
+int main(int argc, char *argv[]){
+    ToolOptions options;
+
+    for(int i=1; i<argc; i++){
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "-l") == 0 && hasValue) options.level = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-g") == 0 && hasValue) options.solver.maxGenerations = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-b") == 0 && hasValue) options.solver.beamWidth = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-s") == 0 && hasValue) options.solver.shotsPerGeneration = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-t") == 0 && hasValue) options.solver.threads = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-v") == 0) options.verbose = true;
+        else if(argv[i][0] != '-') options.path = argv[i];
+        else{
+            std::fprintf(stderr, "usage: %s [levels.txt] [-l level] [-g generations] [-b beam] [-s shots] [-t threads] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<LevelParser::Level> levels;
+    if(!LevelParser::parseFile(options.path, levels)){
+        std::fprintf(stderr, "The file %s can't be read\n", options.path.c_str());
+        return 1;
+    }
+    if(options.level >= int(levels.size())){
+        std::fprintf(stderr, "The file has only %zu levels\n", levels.size());
+        return 1;
+    }
+
+    bool allSolved = true;
+    for(int l=0; l<int(levels.size()); l++){
+        if(options.level >= 0 && l != options.level) continue;
+        if(!solveLevel(l, levels[l], options)) allSolved = false;
+    }
+    return allSolved ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include "AudioMonitor.hpp"
+#include <cstdio>
+
+const int AudioMonitor::buckets;
+const int AudioMonitor::spikeCount;
+
+AudioMonitor::AudioMonitor(int sampleRate, double spikeLoad){
+    setup(sampleRate, spikeLoad);
+}
+
+//it must be called before the audio thread starts
+void AudioMonitor::setup(int _sampleRate, double _spikeLoad){
+    sampleRate = _sampleRate > 0 ? _sampleRate : 44100;
+    spikeLoad = _spikeLoad;
+    spikesRead = 0;
+    reset();
+}
+
+void AudioMonitor::requestReset(){
+    resetRequested.store(true, std::memory_order_relaxed);
+}
+
+//only the audio thread (or setup(), before it starts) clears the counters
+void AudioMonitor::reset(){
+    resetRequested.store(false, std::memory_order_relaxed);
+    origin = Clock::now();
+    hasStarted = false;
+    callbacks.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    deadline.store(0, std::memory_order_relaxed);
+    totalDuration.store(0, std::memory_order_relaxed);
+    worstDuration.store(0, std::memory_order_relaxed);
+    worstLoad.store(0, std::memory_order_relaxed);
+    worstCallback.store(-1, std::memory_order_relaxed);
+    worstInterval.store(0, std::memory_order_relaxed);
+    for(std::atomic<long> &bucket : histogram) bucket.store(0, std::memory_order_relaxed);
+    for(SpikeSlot &slot : spikes) slot.sequence.store(0, std::memory_order_relaxed);
+    spikesWritten.store(0, std::memory_order_release);
+}
+
+AudioMonitor::Clock::time_point AudioMonitor::begin(){
+    if(resetRequested.load(std::memory_order_relaxed)) reset();
+
+    Clock::time_point start = Clock::now();
+    if(hasStarted){
+        double interval = std::chrono::duration<double, std::micro>(start - lastStart).count();
+        if(interval > worstInterval.load(std::memory_order_relaxed)) worstInterval.store(interval, std::memory_order_relaxed);
+    }
+    lastStart = start;
+    hasStarted = true;
+    return start;
+}
+
+/*
+ END
+
+ The audio thread is the only writer, so every counter is a relaxed load and store (no read-modify-write).
+ A spike's slot is written between 2 sequence numbers (2 * index + 1 while it is written, 2 * index + 2 when it is complete): the reader discards a slot that has been overwritten in the meantime.
+*/
+void AudioMonitor::end(Clock::time_point start, int frames){
+    Clock::time_point stop = Clock::now();
+    double duration = std::chrono::duration<double, std::micro>(stop - start).count();
+    double callbackDeadline = frames * 1e6 / sampleRate;
+    double load = callbackDeadline > 0 ? duration / callbackDeadline : 0;
+    long index = callbacks.load(std::memory_order_relaxed);
+
+    deadline.store(callbackDeadline, std::memory_order_relaxed);
+    totalDuration.store(totalDuration.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    if(load > 1) overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic<long> &bucket = histogram[bucketOf(load)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if(duration > worstDuration.load(std::memory_order_relaxed)){
+        worstDuration.store(duration, std::memory_order_relaxed);
+        worstLoad.store(load, std::memory_order_relaxed);
+        worstCallback.store(index, std::memory_order_relaxed);
+    }
+
+    if(load >= spikeLoad){
+        long written = spikesWritten.load(std::memory_order_relaxed);
+        SpikeSlot &slot = spikes[written % spikeCount];
+        slot.sequence.store(2 * written + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.callback.store(index, std::memory_order_relaxed);
+        slot.time.store(std::chrono::duration<double>(start - origin).count(), std::memory_order_relaxed);
+        slot.duration.store(duration, std::memory_order_relaxed);
+        slot.load.store(load, std::memory_order_relaxed);
+        slot.sequence.store(2 * written + 2, std::memory_order_release);
+        spikesWritten.store(written + 1, std::memory_order_release);
+    }
+    callbacks.store(index + 1, std::memory_order_release);
+}
+
+AudioMonitor::Report AudioMonitor::getReport() const{
+    Report report;
+    report.callbacks = callbacks.load(std::memory_order_acquire);
+    report.overruns = overruns.load(std::memory_order_relaxed);
+    report.deadline = deadline.load(std::memory_order_relaxed);
+    report.meanDuration = report.callbacks > 0 ? totalDuration.load(std::memory_order_relaxed) / report.callbacks : 0;
+    report.worstDuration = worstDuration.load(std::memory_order_relaxed);
+    report.worstLoad = worstLoad.load(std::memory_order_relaxed);
+    report.worstCallback = worstCallback.load(std::memory_order_relaxed);
+    report.worstInterval = worstInterval.load(std::memory_order_relaxed);
+    for(int b=0; b<buckets; b++) report.histogram[b] = histogram[b].load(std::memory_order_relaxed);
+    report.spikes = spikesWritten.load(std::memory_order_relaxed);
+    return report;
+}
+
+//if the reader is more than spikeCount spikes behind, the oldest ones are lost (the log skips them)
+bool AudioMonitor::readSpike(Spike &spike){
+    long written = spikesWritten.load(std::memory_order_acquire);
+    if(spikesRead > written) spikesRead = 0;                        //the counters have been reset
+    if(spikesRead < written - spikeCount) spikesRead = written - spikeCount;
+
+    while(spikesRead < written){
+        const SpikeSlot &slot = spikes[spikesRead % spikeCount];
+        long sequence = slot.sequence.load(std::memory_order_acquire);
+        spike.callback = slot.callback.load(std::memory_order_relaxed);
+        spike.time = slot.time.load(std::memory_order_relaxed);
+        spike.duration = slot.duration.load(std::memory_order_relaxed);
+        spike.load = slot.load.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        bool complete = sequence == 2 * spikesRead + 2 && slot.sequence.load(std::memory_order_relaxed) == sequence;
+        spikesRead++;
+        if(complete) return true;
+    }
+    return false;
+}
+
+int AudioMonitor::bucketOf(double load){
+    if(load < 1) return int(load * 10);
+    if(load < 1.5) return 10;
+    if(load < 2) return 11;
+    return 12;
+}
+
+const char *AudioMonitor::bucketName(int bucket){
+    static const char *names[buckets] = {"0-10%", "10-20%", "20-30%", "30-40%", "40-50%", "50-60%", "60-70%", "70-80%", "80-90%", "90-100%", "100-150%", "150-200%", ">200%"};
+    return bucket >= 0 && bucket < buckets ? names[bucket] : "";
+}
+
+//the empty buckets are not written
+std::string AudioMonitor::toString(const Report &report){
+    char line[256];
+    std::snprintf(line, sizeof(line), "callbacks=%ld overruns=%ld deadline_us=%.0f mean_us=%.1f worst_us=%.1f worst_load=%.0f%% worst_callback=%ld worst_interval_us=%.0f spikes=%ld histogram=",
+                  report.callbacks, report.overruns, report.deadline, report.meanDuration, report.worstDuration, report.worstLoad * 100,
+                  report.worstCallback, report.worstInterval, report.spikes);
+    std::string text = line;
+    bool first = true;
+    for(int b=0; b<buckets; b++){
+        if(report.histogram[b] == 0) continue;
+        text += (first ? "" : ",") + std::string(bucketName(b)) + ":" + std::to_string(report.histogram[b]);
+        first = false;
+    }
+    return text;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ AUDIOMONITOR
+ The AudioMonitor class measures how close the audio callback comes to its deadline: a callback of n frames must be ready in n / sampleRate seconds (the buffer's period), or the sound device plays a gap (an xrun).
+ The same measure is used by the game (Game::audioOut()) and by the simulated stream (see SimulatedStream).
+
+ A callback is measured by an AudioMonitor::Scope object (like Tracer::Scope): it reads the clock when it is created and when it is destroyed.
+    AudioMonitor::Scope measure(audioMonitor, bufferSize);
+ Every callback is recorded as its load (CPU time / deadline):
+    -the histogram => buckets of 10% of the deadline up to 100%, then 100-150%, 150-200% and over 200%
+    -the overruns => the callbacks longer than their deadline
+    -the worst callback => its time, its load and its index
+    -the spikes => the callbacks over spikeLoad (80% of the deadline by default) are written in a ring of the last spikeCount spikes, read by another thread for the log (readSpike())
+ The interval between the starts of two callbacks is recorded too (the worst one): a driver that calls late has no time left for the callback.
+
+ Only the audio thread writes (relaxed atomics, no locks and no allocations), the other threads read a Report. A reset is only requested: the audio thread clears the counters at its next callback.
+
+ The methods are:
+
+ -setup() => it sets the sample rate and the spikes' threshold, and it clears the counters
+ -begin() => (audio thread) it marks the beginning of a callback, it returns its start (Scope calls it)
+ -end() => (audio thread) it records a callback (Scope calls it)
+ -getReport() => it returns the counters (the histogram, the overruns, the mean and the worst callback)
+ -readSpike() => it reads the next spike not read yet, it returns false if there aren't new spikes (only one reader thread)
+ -requestReset() => the counters are cleared at the next callback
+ -toString() => it writes a report in one line (the log)
+ -bucketName() => it returns the range of a histogram's bucket ("0-10%", ..., ">200%")
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class AudioMonitor{
+
+    public:
+        static const int buckets = 13;
+        static const int spikeCount = 64;
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Spike{
+            long callback = 0;                  //the callback's index (since the last reset)
+            double time = 0;                    //seconds since the last reset
+            double duration = 0;                //microseconds
+            double load = 0;                    //duration / deadline
+        };
+
+        struct Report{
+            long callbacks = 0;
+            long overruns = 0;
+            double deadline = 0;                //microseconds of the last callback's buffer
+            double meanDuration = 0;            //microseconds
+            double worstDuration = 0;
+            double worstLoad = 0;
+            long worstCallback = -1;
+            double worstInterval = 0;           //microseconds between the starts of two callbacks
+            std::array<long, buckets> histogram{};
+            long spikes = 0;                    //callbacks over spikeLoad
+        };
+
+        class Scope{
+            private:
+                AudioMonitor &monitor;
+                Clock::time_point start;
+                int frames;
+
+            public:
+                Scope(AudioMonitor &_monitor, int _frames) : monitor(_monitor), start(_monitor.begin()), frames(_frames){}
+                ~Scope(){
+                    monitor.end(start, frames);
+                }
+        };
+
+        AudioMonitor(int sampleRate = 44100, double spikeLoad = 0.8);
+        void setup(int _sampleRate, double _spikeLoad = 0.8);
+        Clock::time_point begin();
+        void end(Clock::time_point start, int frames);
+        Report getReport() const;
+        bool readSpike(Spike &spike);
+        void requestReset();
+        static std::string toString(const Report &report);
+        static const char *bucketName(int bucket);
+
+    private:
+        struct SpikeSlot{
+            std::atomic<long> sequence;         //odd while the audio thread writes the slot
+            std::atomic<long> callback;
+            std::atomic<double> time;
+            std::atomic<double> duration;
+            std::atomic<double> load;
+        };
+
+        int sampleRate;
+        double spikeLoad;
+
+        std::atomic<bool> resetRequested;
+        Clock::time_point origin;               //the time of the last reset (audio thread)
+        Clock::time_point lastStart;
+        bool hasStarted;                        //false before the first callback after a reset
+
+        std::atomic<long> callbacks;
+        std::atomic<long> overruns;
+        std::atomic<double> deadline;
+        std::atomic<double> totalDuration;
+        std::atomic<double> worstDuration;
+        std::atomic<double> worstLoad;
+        std::atomic<long> worstCallback;
+        std::atomic<double> worstInterval;
+        std::array<std::atomic<long>, buckets> histogram;
+        std::array<SpikeSlot, spikeCount> spikes;
+        std::atomic<long> spikesWritten;
+        long spikesRead;                        //the reader's index
+
+        void reset();
+        static int bucketOf(double load);
+
+};
@@ -0,0 +1,239 @@
+#include "BitBoard.hpp"
+#include "LifeKernel.hpp"
+#include <algorithm>
+#include <bitset>
+
+/*
+ BITBOARD contructor
+
+ When a board is created, all its cells are dead.
+*/
+BitBoard::BitBoard(int _width, int _height){
+    resize(_width, _height);
+}
+
+/*
+ it changes the size of the board. All the cells are dead after this call.
+ If the new size fits in the current storage, nothing is allocated.
+*/
+void BitBoard::resize(int _width, int _height){
+    width = _width;
+    height = _height;
+    wordsPerRow = (width + 63) / 64;
+    lastWordMask = (width % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (width % 64)) - 1;
+    
+    words.assign(size_t(wordsPerRow) * height, 0);
+}
+
+void BitBoard::clear(){
+    std::fill(words.begin(), words.end(), 0);
+}
+
+bool BitBoard::get(int x, int y) const{
+    return (words[size_t(y) * wordsPerRow + x / 64] >> (x % 64)) & 1;
+}
+
+void BitBoard::set(int x, int y, bool alive){
+    uint64_t bit = uint64_t(1) << (x % 64);
+    uint64_t &word = words[size_t(y) * wordsPerRow + x / 64];
+    if(alive) word |= bit;
+    else word &= ~bit;
+}
+
+int BitBoard::getWidth() const{
+    return width;
+}
+
+int BitBoard::getHeight() const{
+    return height;
+}
+
+int BitBoard::getWordsPerRow() const{
+    return wordsPerRow;
+}
+
+uint64_t *BitBoard::getRow(int y){
+    return &words[size_t(y) * wordsPerRow];
+}
+
+const uint64_t *BitBoard::getRow(int y) const{
+    return &words[size_t(y) * wordsPerRow];
+}
+
+//one popcount for every word (std::bitset::count becomes a single instruction on the CPUs that have it)
+int BitBoard::countAlive() const{
+    int aliveCells = 0;
+    for(uint64_t word : words){
+        aliveCells += std::bitset<64>(word).count();
+    }
+    return aliveCells;
+}
+
+//the rectangle is clipped to the board, then the rows are checked one word at a time
+bool BitBoard::isRegionEmpty(int fromX, int fromY, int toX, int toY) const{
+    fromX = std::max(fromX, 0);
+    fromY = std::max(fromY, 0);
+    toX = std::min(toX, width);
+    toY = std::min(toY, height);
+    if(fromX >= toX || fromY >= toY) return true;
+
+    int fromWord = fromX / 64;
+    int toWord = (toX - 1) / 64;
+    for(int y=fromY; y<toY; y++){
+        const uint64_t *row = getRow(y);
+
+        for(int i=fromWord; i<=toWord; i++){
+            uint64_t mask = ~uint64_t(0);
+            if(i == fromWord) mask &= ~uint64_t(0) << (fromX % 64);
+            if(i == toWord && toX % 64 != 0) mask &= (uint64_t(1) << (toX % 64)) - 1;
+            if(row[i] & mask) return false;
+        }
+    }
+    return true;
+}
+
+/*
+ COUNTNEIGHBOURS
+
+ horizontal => the neighbours in the row (x - 1, x + 1) are counted, vertical => the neighbours in the column (y - 1, y + 1), both => all the 8 neighbours.
+ With the PACMAN effect (torus) a neighbour before the first column is in the last column and a neighbour after the last column is in the first one (the same for the rows), also when (x, y) is outside the board.
+ Without it, the neighbours outside the board are dead.
+*/
+int BitBoard::countNeighbours(int x, int y, bool horizontal, bool vertical, bool torus) const{
+    int count = 0;
+    int rangeX = horizontal ? 1 : 0;
+    int rangeY = vertical ? 1 : 0;
+
+    for(int dy=-rangeY; dy<=rangeY; dy++){
+        for(int dx=-rangeX; dx<=rangeX; dx++){
+            if(dx == 0 && dy == 0) continue;            //the current cell is not calculated as a neighbour
+            int neighbourX = x + dx;
+            int neighbourY = y + dy;
+
+            if(!torus && (neighbourX < 0 || neighbourY < 0 || neighbourX >= width || neighbourY >= height)) continue;
+            if(neighbourX < 0) neighbourX = width - 1;
+            if(neighbourY < 0) neighbourY = height - 1;
+            if(neighbourX >= width) neighbourX = 0;
+            if(neighbourY >= height) neighbourY = 0;
+
+            if(get(neighbourX, neighbourY)) count++;
+        }
+    }
+    return count;
+}
+
+size_t BitBoard::getMemorySize() const{
+    return sizeof(BitBoard) + words.capacity() * sizeof(uint64_t);
+}
+
+//the words allocated for the board: it changes only when the storage is reallocated
+size_t BitBoard::getCapacity() const{
+    return words.capacity();
+}
+
+/*
+ ZOBRIST HASH
+
+ The classic Zobrist hash has a random key for every cell, and the hash is the XOR of the keys of the alive cells. Here the key is computed (not stored) for every word: it mixes the word's index and its value (the splitmix64 finalizer), and an empty word has key 0.
+ So the hash of a board is the XOR of the keys of its non empty words, and when a word changes from a to b the hash is updated with "hash ^= wordKey(i, a) ^ wordKey(i, b)", without reading the rest of the board.
+*/
+uint64_t BitBoard::wordKey(size_t index, uint64_t value){
+    if(value == 0) return 0;
+    uint64_t key = value ^ (uint64_t(index) * 0x9E3779B97F4A7C15ULL);
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+uint64_t BitBoard::getHash() const{
+    uint64_t hash = 0;
+    for(size_t i=0; i<words.size(); i++) hash ^= wordKey(i, words[i]);
+    return hash;
+}
+
+/*
+ NEXTGENERATION
+
+ It computes the next generation of the whole board. With the Conway's Game of Life rules:
+     - Each alive cell with one or no neighbors dies, as if by solitude.
+     - Each alive cell with four or more neighbors dies, as if by overpopulation.
+     - Each alive cell with two or three neighbors survives.
+     - Each dead cell with three neighbors becomes populated.
+
+ The new generation is written in a second board (with the same size), because if we change directly the values in the current board, the algorithm doesn't work as expected.
+ Nothing is allocated here: the caller owns both the boards (see LifeEngine).
+*/
+void BitBoard::nextGeneration(BitBoard &next, const LifeRule &rule) const{
+    for(int word=0; word<wordsPerRow; word++){
+        nextTile(next, word, 0, height, rule);
+    }
+}
+
+/*
+ NEXTTILE
+
+ It computes only the word "word" (64 columns) of the rows from fromY to toY-1. The other words of the next board are not touched.
+ It is used to skip the stable parts of the board (see LifeEngine). It returns true if at least one cell of the tile changed.
+ The rule is selected here, once for the whole tile. If changes is passed, it is set to the births, the deaths and the hash change of the tile.
+*/
+bool BitBoard::nextTile(BitBoard &next, int word, int fromY, int toY, const LifeRule &rule, TileChanges *changes) const{
+    return LifeKernel::selectRule(rule, [&](const auto &kernelRule){
+        return nextTileKernel(next, word, fromY, toY, kernelRule, changes);
+    });
+}
+
+//the births, the deaths and the hash change are computed only for the changed words (the old and the new values), so they cost nothing more than a scan on stable tiles
+template<class Rule>
+bool BitBoard::nextTileKernel(BitBoard &next, int word, int fromY, int toY, const Rule &rule, TileChanges *changes) const{
+    TileChanges tileChanges;
+
+    for(int y=fromY; y<toY; y++){
+        /*the famous PACMAN effect (on the rows)*/
+        int up = (y == 0) ? height-1 : y-1;
+        int down = (y == height-1) ? 0 : y+1;
+
+        uint64_t prevWordValue = getRow(y)[word];
+        uint64_t nextWordValue = nextWord(getRow(up), getRow(y), getRow(down), word, rule);
+        if(nextWordValue != prevWordValue){
+            size_t index = size_t(y) * wordsPerRow + word;
+            tileChanges.births += std::bitset<64>(nextWordValue & ~prevWordValue).count();
+            tileChanges.deaths += std::bitset<64>(prevWordValue & ~nextWordValue).count();
+            tileChanges.hash ^= wordKey(index, prevWordValue) ^ wordKey(index, nextWordValue);
+        }
+        next.getRow(y)[word] = nextWordValue;
+    }
+
+    if(changes) *changes = tileChanges;
+    return tileChanges.births + tileChanges.deaths > 0;
+}
+
+/*
+ NEXTWORD
+
+ It computes 64 cells at a time: the word i of the row (see LifeKernel::nextCells()).
+ The carries between the words and the PACMAN effect (on the columns) are handled when the rows are shifted: the first cell of the row is the right neighbour of the last cell and vice versa.
+*/
+template<class Rule>
+uint64_t BitBoard::nextWord(const uint64_t *up, const uint64_t *row, const uint64_t *down, int i, const Rule &rule) const{
+    const int lastWord = wordsPerRow - 1;
+    const int lastBit = (width - 1) % 64;
+    const uint64_t *rows[3] = {up, row, down};
+    uint64_t left[3], center[3], right[3];
+
+    for(int r=0; r<3; r++){
+        const uint64_t *current = rows[r];
+
+        //left neighbours: the bit x contains the cell x-1
+        uint64_t leftCarry = (i > 0) ? current[i-1] >> 63 : (current[lastWord] >> lastBit) & 1;
+        //right neighbours: the bit x contains the cell x+1
+        uint64_t rightCarry = (i < lastWord) ? current[i+1] << 63 : (current[0] & 1) << lastBit;
+
+        center[r] = current[i];
+        left[r] = (current[i] << 1) | leftCarry;
+        right[r] = (current[i] >> 1) | rightCarry;
+    }
+
+    uint64_t next = LifeKernel::nextCells(left, center, right, rule);
+    if(i == lastWord) next &= lastWordMask;
+    return next;
+}
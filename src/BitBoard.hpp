@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "LifeRule.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ BITBOARD
+ The BitBoard class is the simulation core of the game's grid. It stores the board as rows of 64-bit words (1 bit per cell, 64 cells per word), so a whole generation is computed 64 cells at a time with bitwise adders instead of counting the neighbours cell by cell.
+
+ The cell (x, y) is the bit (x % 64) of the word (x / 64) in the row y. The bits after the width (in the last word of every row) are always 0.
+ The board is a torus (the PACMAN effect): the neighbours of the first column are in the last column and the same for the rows.
+
+ The generation is computed with a LifeRule (Conway's rules by default). The common rules have their own kernel, specialized at compile time (see LifeKernel), the other rules use a generic kernel.
+
+ The methods are:
+
+ -BitBoard() => it creates a dead board of width * height cells
+ -resize() => it changes the board's size and kills all the cells
+ -clear() => it kills all the cells
+ -get() => it returns the state of the cell (x, y)
+ -set() => it sets the state of the cell (x, y)
+ -getWidth() => it returns the number of columns
+ -getHeight() => it returns the number of rows
+ -getWordsPerRow() => it returns the number of 64-bit words of every row
+ -getRow() => it returns a pointer to the first word of the row y
+ -countAlive() => it counts the alive cells (one popcount for every word)
+ -isRegionEmpty() => it returns true if there aren't alive cells in the rectangle [fromX, toX) * [fromY, toY) (it can be partially outside the board)
+ -countNeighbours() => it counts the alive neighbours of the cell (x, y) in the row, in the column or in both (the rocket's collisions)
+ -getMemorySize() => it returns the bytes used by the board
+ -nextGeneration() => it writes the next generation (with the passed rule) in another board of the same size
+ -nextTile() => same as nextGeneration(), but only for one word (64 columns) of some rows. It returns true if the tile changed (and it can write the tile's births, deaths and hash change in a TileChanges)
+ -getHash() => it returns the Zobrist hash of the board (see wordKey())
+ -wordKey() => it returns the Zobrist key of a word's value: the hash of a board is the XOR of the keys of its words, so when a word changes the hash is updated with 2 keys
+ -getCapacity() => it returns the words of the board's storage (the owner of a board can count its reallocations, see LifeEngine::getAllocationCount())
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct TileChanges{
+    int births = 0;                             //cells born in the tile
+    int deaths = 0;                             //cells dead in the tile
+    uint64_t hash = 0;                          //XOR of the old and the new keys of the changed words (hash ^= TileChanges::hash)
+};
+
+
+class BitBoard{
+
+    private:
+        int width;
+        int height;
+        int wordsPerRow;
+        uint64_t lastWordMask;                  //valid bits of the last word of every row
+        std::vector<uint64_t> words;            //row after row, wordsPerRow words for each row
+
+        template<class Rule> bool nextTileKernel(BitBoard &next, int word, int fromY, int toY, const Rule &rule, TileChanges *changes) const;
+        template<class Rule> uint64_t nextWord(const uint64_t *up, const uint64_t *row, const uint64_t *down, int i, const Rule &rule) const;
+
+    public:
+        BitBoard(int _width = 0, int _height = 0);
+        void resize(int _width, int _height);
+        void clear();
+        bool get(int x, int y) const;
+        void set(int x, int y, bool alive);
+        int getWidth() const;
+        int getHeight() const;
+        int getWordsPerRow() const;
+        uint64_t *getRow(int y);
+        const uint64_t *getRow(int y) const;
+        int countAlive() const;
+        bool isRegionEmpty(int fromX, int fromY, int toX, int toY) const;
+        int countNeighbours(int x, int y, bool horizontal, bool vertical, bool torus = true) const;
+        size_t getMemorySize() const;
+        void nextGeneration(BitBoard &next, const LifeRule &rule = LifeRule::conway()) const;
+        bool nextTile(BitBoard &next, int word, int fromY, int toY, const LifeRule &rule = LifeRule::conway(), TileChanges *changes = nullptr) const;
+        uint64_t getHash() const;
+        static uint64_t wordKey(size_t index, uint64_t value);
+        size_t getCapacity() const;
+
+};
@@ -0,0 +1,325 @@
+#include "BlockSynth.hpp"
+#include <algorithm>
+#include <cmath>
+
+const int BlockSynth::blockSize;
+constexpr double BlockSynth::attack;
+constexpr double BlockSynth::release;
+constexpr double BlockSynth::silence;
+
+BlockSynth::BlockSynth(){
+    setup(44100, std::vector<double>(), 8);
+}
+
+/*
+ SETUP
+
+ The voices with the same frequency are linked to the same oscillator (the oscillators are in order of first voice).
+ The pan is the same of maxiMix::stereo(): 0 => left, 1 => right.
+*/
+void BlockSynth::setup(double _sampleRate, const std::vector<double> &frequencies, double beatsPerSecond, double pan){
+    sampleRate = _sampleRate;
+    tickIncrement = beatsPerSecond / sampleRate;
+    tickPhase = 0;
+    column = 0;
+    playedVoices = 0;
+    pan = std::min(std::max(pan, 0.0), 1.0);
+    leftGain = float(std::sqrt(1.0 - pan));
+    rightGain = float(std::sqrt(pan));
+
+    voices.assign(frequencies.size(), Voice());
+    increments.clear();
+    std::vector<double> oscillatorFrequencies;
+    for(size_t v=0; v<frequencies.size(); v++){
+        auto found = std::find(oscillatorFrequencies.begin(), oscillatorFrequencies.end(), frequencies[v]);
+        voices[v].oscillator = int(found - oscillatorFrequencies.begin());
+        if(found == oscillatorFrequencies.end()){
+            oscillatorFrequencies.push_back(frequencies[v]);
+            increments.push_back(frequencies[v] / sampleRate);
+        }
+    }
+
+    int oscillators = int(increments.size());
+    moving.clear();
+    moving.reserve(voices.size());
+    phases.assign(oscillators, 0);
+    held.assign(oscillators, 0);
+    weights.assign(oscillators, 0);
+    slotGains.assign(oscillators, 0);
+    slotTargets.assign(oscillators, 0);
+    muted.assign(oscillators, false);
+    ranking.assign(oscillators, 0);
+    audibleVoices = 0;
+    stolenVoices = 0;
+    gains.assign(size_t(oscillators) * blockSize, 0);
+    steps.assign(size_t(oscillators) * blockSize, 0);
+    sines.assign(blockSize, 0);
+    mono.assign(blockSize, 0);
+}
+
+//the soundtrack's keyboard: a key for every row (the Soundtrack in the game, the offline render without audio device)
+void BlockSynth::setupKeyboard(double _sampleRate, int rows, const KeyboardOptions &options){
+    setup(_sampleRate, harmonicFrequencies(rows, options), options.beatsPerSecond, options.pan);
+    setVoiceLimit(options.voiceLimit);
+}
+
+/*
+ HARMONICFREQUENCIES
+
+ The Keys frequencies are selected here. It's important to notice that the harmonic series is an arithmetic series (1×f, 2×f, 3×f, 4×f, 5×f, ...)
+ The rows with the same harmonic share their oscillator.
+*/
+std::vector<double> BlockSynth::harmonicFrequencies(int rows, const KeyboardOptions &options){
+    std::vector<double> frequencies;
+    for(int y=0; y<rows; y++){
+        frequencies.push_back(options.lowestFrequency * (y % options.harmonics + 1));    //y goes from 0 to harmonics-1 cyclically
+    }
+    return frequencies;
+}
+
+int BlockSynth::getVoiceCount() const{
+    return int(voices.size());
+}
+
+int BlockSynth::getOscillatorCount() const{
+    return int(increments.size());
+}
+
+//0 => no limit. The limit can be changed while the synth plays (from the audio thread)
+void BlockSynth::setVoiceLimit(int limit){
+    voiceLimit = std::max(limit, 0);
+}
+
+int BlockSynth::getVoiceLimit() const{
+    return voiceLimit;
+}
+
+int BlockSynth::getAudibleVoices() const{
+    return audibleVoices;
+}
+
+long BlockSynth::getStolenVoices() const{
+    return stolenVoices;
+}
+
+/*
+ RENDER
+
+ The played rows are the board's rows that have a voice. The volume is divided by the played rows (the sum of all the pressed keys is at most 1).
+ The channels after the second one are silent.
+*/
+void BlockSynth::render(const BitBoard &board, float *output, int frames, int channels){
+    const int played = std::min(board.getHeight(), int(voices.size()));
+    const int columns = board.getWidth();
+    const int oscillators = int(increments.size());
+    if(played < playedVoices) stopVoices(played);
+    playedVoices = played;
+    if(column >= columns) column = 0;                               //a narrower board restarts from the first column
+    const float volume = played > 0 ? 1.0f / played : 0.0f;
+
+    for(int offset=0; offset<frames; offset+=blockSize){
+        const int count = std::min(blockSize, frames - offset);
+        std::fill(gains.begin(), gains.end(), 0.0f);
+        std::fill(steps.begin(), steps.end(), 0.0f);
+
+        //the ticks of the maxiOsc::phasor() metronome: the column changes exactly at its sample
+        int from = 0;
+        for(int t=0; t<count; t++){
+            bool tick = tickPhase >= 1.0;
+            if(tick) tickPhase -= 1.0;
+            tickPhase += tickIncrement;
+            if(!tick || columns == 0) continue;
+
+            renderEnvelopes(from, t);
+            setGates(board, t);
+            column = column < columns - 1 ? column + 1 : 0;
+            from = t;
+        }
+        renderEnvelopes(from, count);
+
+        //the held voices are a running sum of their steps (it isn't vectorizable, but it is only a sum for every oscillator)
+        for(int o=0; o<oscillators; o++){
+            float *gain = &gains[size_t(o) * blockSize];
+            const float *step = &steps[size_t(o) * blockSize];
+            float level = held[o];
+            float weight = 0;
+            for(int t=0; t<count; t++){
+                level += step[t];
+                gain[t] += level;
+                weight += gain[t];
+            }
+            held[o] = level;
+            weights[o] = weight;
+        }
+        selectVoices();
+
+        std::fill(mono.begin(), mono.begin() + count, 0.0f);
+        for(int o=0; o<oscillators; o++){
+            const float from = slotGains[o], to = slotTargets[o];
+            slotGains[o] = to;
+            if(from == 0 && to == 0) continue;                      //silent or stolen: only its phase moves
+
+            sineKernel(sines.data(), phases[o], increments[o], count);
+            const float *gain = &gains[size_t(o) * blockSize];
+            const float *sine = sines.data();
+            const float fade = (to - from) / count;
+            float *mix = mono.data();
+            for(int t=0; t<count; t++) mix[t] += gain[t] * sine[t] * (from + fade * t);
+        }
+        for(int o=0; o<oscillators; o++){
+            phases[o] += increments[o] * count;
+            phases[o] -= std::floor(phases[o]);
+        }
+
+        float *out = output + size_t(offset) * channels;
+        const float left = leftGain * volume, right = rightGain * volume;
+        for(int t=0; t<count; t++){
+            for(int c=0; c<channels; c++) out[t * channels + c] = c == 0 ? mono[t] * left : c == 1 ? mono[t] * right : 0.0f;
+        }
+    }
+}
+
+/*
+ SINEKERNEL
+
+ The phase of the sample t is phase + t * increment (the phase before the increment, like maxiOsc::sinewave()), reduced to [-0.25, 0.25] turns with the sine's symmetries.
+ The sine is a Taylor polynomial of degree 11 on [-pi/2, pi/2] (error < 1e-7). The loop has no branches (the reductions are selections), so the compiler vectorizes it.
+*/
+void BlockSynth::sineKernel(float *out, double phase, double increment, int frames){
+    const float start = float(phase);
+    const float step = float(increment);
+    for(int t=0; t<frames; t++){
+        float turns = start + step * float(t);
+        turns -= float(int(turns));                                 //[0, 1) (turns is positive)
+        float x = 0.5f - turns;                                     //sin(2pi * turns) = sin(2pi * (0.5 - turns))
+        x = x > 0.25f ? 0.5f - x : x;
+        x = x < -0.25f ? -0.5f - x : x;
+        const float a = 6.28318530718f * x;
+        const float a2 = a * a;
+        out[t] = a * (1.0f + a2 * (-1.0f / 6 + a2 * (1.0f / 120 + a2 * (-1.0f / 5040 + a2 * (1.0f / 362880 + a2 * (-1.0f / 39916800))))));
+    }
+}
+
+/*
+ SETGATES
+
+ The gates of the played rows follow the column's cells (Soundtrack's setToPlayKeys()). Like maxiEnv::ar(), an open gate restarts the attack of a silent or released voice (from its current amplitude).
+ A held voice whose gate closes is not held anymore from this sample: it starts its release.
+*/
+void BlockSynth::setGates(const BitBoard &board, int sample){
+    const int word = column / 64;
+    const int bit = column % 64;
+    for(int y=0; y<playedVoices; y++){
+        Voice &voice = voices[y];
+        bool gate = (board.getRow(y)[word] >> bit) & 1;
+        if(gate == voice.gate) continue;
+        voice.gate = gate;
+
+        if(gate){
+            if(voice.stage == IDLE) moving.push_back(y);
+            if(voice.stage == IDLE || voice.stage == RELEASE) voice.stage = ATTACK;
+        }
+        else if(voice.stage == HOLD){
+            steps[size_t(voice.oscillator) * blockSize + sample] -= 1.0f;
+            moving.push_back(y);
+        }
+    }
+}
+
+/*
+ RENDERENVELOPES
+
+ The gates don't change in [from, to): every moving voice is computed sample by sample until it is held at 1 (a +1 step) or silent, the other voices don't change.
+ The stages are the ones of maxiEnv::ar() with holdtime 1: the attack ends when the amplitude reaches 1, and if the gate is already closed the release starts in the same sample.
+*/
+void BlockSynth::renderEnvelopes(int from, int to){
+    for(size_t i=0; i<moving.size(); ){
+        Voice &voice = voices[moving[i]];
+        float *gain = &gains[size_t(voice.oscillator) * blockSize];
+        double amplitude = voice.amplitude;
+        Stage stage = voice.stage;
+
+        int t = from;
+        for(; t<to && stage != IDLE; t++){
+            if(stage == ATTACK){
+                amplitude += attack;
+                if(amplitude < 1.0){
+                    gain[t] += float(amplitude);
+                    continue;
+                }
+                amplitude = 1.0;
+                if(voice.gate){
+                    stage = HOLD;
+                    steps[size_t(voice.oscillator) * blockSize + t] += 1.0f;
+                    break;
+                }
+            }
+            stage = RELEASE;                                        //a closed HOLD releases immediately
+            amplitude *= release;
+            if(amplitude < silence){
+                stage = IDLE;
+                amplitude = 0;
+            }
+            else gain[t] += float(amplitude);
+        }
+
+        voice.amplitude = amplitude;
+        voice.stage = stage;
+        if(stage == IDLE || stage == HOLD){
+            moving[i] = moving.back();
+            moving.pop_back();
+        }
+        else i++;
+    }
+}
+
+/*
+ SELECTVOICES
+
+ The audible oscillators (a gain in the block) are the pooled voices. If they are more than voiceLimit, the loudest ones (the sum of their gains in the block) are played and the others are stolen: they fade out in this block, and they fade in when they get a voice again.
+ A silent oscillator doesn't take a voice, and when it starts again it is played at full volume (its envelopes start from 0).
+*/
+void BlockSynth::selectVoices(){
+    const int oscillators = int(increments.size());
+    audibleVoices = 0;
+    for(int o=0; o<oscillators; o++){
+        if(weights[o] > 0) ranking[audibleVoices++] = o;
+        else{
+            slotGains[o] = 0;                                       //nothing to fade: it is silent
+            slotTargets[o] = 0;
+            muted[o] = false;
+        }
+    }
+
+    int played = audibleVoices;
+    if(voiceLimit > 0 && played > voiceLimit){
+        std::nth_element(ranking.begin(), ranking.begin() + voiceLimit, ranking.begin() + audibleVoices, [this](int a, int b){
+            return weights[a] != weights[b] ? weights[a] > weights[b] : a < b;
+        });
+        played = voiceLimit;
+    }
+
+    for(int i=0; i<audibleVoices; i++){
+        int o = ranking[i];
+        if(i < played){
+            if(!muted[o]) slotGains[o] = 1;
+            slotTargets[o] = 1;
+            muted[o] = false;
+        }
+        else{
+            if(!muted[o] && slotGains[o] > 0) stolenVoices++;      //a new stolen oscillator (silent before) is never heard
+            slotTargets[o] = 0;
+            muted[o] = true;
+        }
+    }
+}
+
+//the voices after from are not played by the new board: their gates close and they are silent immediately
+void BlockSynth::stopVoices(int from){
+    for(size_t v=from; v<voices.size(); v++){
+        Voice &voice = voices[v];
+        if(voice.stage == HOLD && voice.gate) held[voice.oscillator] -= 1.0f;
+        voice = Voice{0, voice.oscillator, IDLE, false};
+    }
+    moving.erase(std::remove_if(moving.begin(), moving.end(), [from](int v){ return v >= from; }), moving.end());
+}
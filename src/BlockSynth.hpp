@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BitBoard.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ BLOCKSYNTH
+ The BlockSynth class renders the soundtrack's sequencer (see Soundtrack) a block of samples at a time, instead of one sample and one key at a time.
+
+ Every row of the board is a voice: a sine oscillator with an attack/release envelope (the same curves of ofxMaxim's maxiEnv::ar(input, 0.1, 0.1, 1, trigger)). The board's columns are played in order, beatsPerSecond columns a second: an alive cell opens its row's gate.
+ The voices with the same frequency have the same phase (they start together and never stop), so they share one oscillator: a level of 512 rows with 5 harmonics computes 5 sines a sample, not 512.
+ The oscillators are the pooled voices: every oscillator is a weighted voice (the sum of the envelopes of its rows), and a silent one (all its rows idle) isn't rendered. So the audio's CPU depends on the audible pitches, not on the board's height.
+ At most voiceLimit oscillators are played (0 => no limit): the loudest ones of the block. The other ones are stolen (see selectVoices()).
+
+ A block is rendered in 4 passes:
+    -the envelopes => the column's ticks are found sample by sample, so the gates change exactly at their sample. A voice is computed sample by sample only during its attack or release (a few samples): the voices held at 1 are only counted (a +1/-1 step in the oscillator's gain when they start or stop)
+    -the pool => the audible oscillators get a voice (see selectVoices())
+    -the sines => one vectorizable loop for every played oscillator (a polynomial sine on floats, without branches or library calls)
+    -the mix => every played oscillator's sine times its gain (the held voices plus the envelopes), divided by the played rows, on 2 stereo channels
+ A voice whose release is under silence is stopped (maxiEnv decays until the denormals), so the silent voices cost nothing.
+
+ The buffers are allocated by setup(): render() never allocates, so it can be called by the audio thread. A buffer longer than blockSize is rendered in more blocks.
+
+ The methods are:
+
+ -setup() => it creates the voices (a frequency for every row) and the buffers
+ -setupKeyboard() => it creates the soundtrack's harmonic keyboard (KeyboardOptions) for rows rows
+ -harmonicFrequencies() => it returns the frequencies of the harmonic keyboard's rows
+ -render() => it renders frames samples of the board's sequencer (interleaved channels)
+ -getVoiceCount() => it returns the number of voices (the max played rows)
+ -getOscillatorCount() => it returns the number of different frequencies
+ -setVoiceLimit() => it sets the max oscillators played at once (0 => no limit)
+ -getVoiceLimit() => it returns the max oscillators played at once
+ -getAudibleVoices() => it returns the audible oscillators of the last block (played or stolen)
+ -getStolenVoices() => it returns how many times a played oscillator has been stolen
+ -sineKernel() => (private) it writes the sine of an oscillator for a block
+ -setGates() => (private) it opens and closes the gates of a column's tick
+ -renderEnvelopes() => (private) it adds the attacks and releases of a part of the block to the gains
+ -selectVoices() => (private) it chooses the played oscillators of the block and their fades
+ -stopVoices() => (private) it silences the voices that aren't played anymore (a board with fewer rows)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct KeyboardOptions{
+    double beatsPerSecond = 8;          //the "sequencer"'s speed (columns played a second)
+    double lowestFrequency = 100;       //the first row's frequency
+    int harmonics = 5;                  //number of used harmonics, if the board's height is bigger, the harmonics are repeated
+    int voiceLimit = 8;                 //the max harmonics played at once (0 => no limit)
+    double pan = 0.5;                   //the stereo mix (0 => left, 1 => right)
+};
+
+
+class BlockSynth{
+
+    public:
+        static const int blockSize = 256;           //samples rendered by the kernels at once
+
+        BlockSynth();
+        void setup(double _sampleRate, const std::vector<double> &frequencies, double beatsPerSecond, double pan = 0.5);
+        void setupKeyboard(double _sampleRate, int rows, const KeyboardOptions &options = KeyboardOptions());
+        static std::vector<double> harmonicFrequencies(int rows, const KeyboardOptions &options = KeyboardOptions());
+        void render(const BitBoard &board, float *output, int frames, int channels);
+        int getVoiceCount() const;
+        int getOscillatorCount() const;
+        void setVoiceLimit(int limit);
+        int getVoiceLimit() const;
+        int getAudibleVoices() const;
+        long getStolenVoices() const;
+
+    private:
+        enum Stage : uint8_t {IDLE, ATTACK, HOLD, RELEASE};
+
+        struct Voice{
+            double amplitude = 0;
+            int oscillator = 0;
+            Stage stage = IDLE;
+            bool gate = false;
+        };
+
+        static constexpr double attack = 0.1;       //added to the amplitude every sample
+        static constexpr double release = 0.1;      //the amplitude is multiplied by it every sample
+        static constexpr double silence = 1e-7;     //a released voice is stopped under this amplitude
+
+        double sampleRate;
+        double tickIncrement;                       //the columns' metronome (a tick when its phase reaches 1)
+        double tickPhase;
+        int column;                                 //the next played column
+        int playedVoices;                           //the rows of the last board
+        int voiceLimit = 0;
+        int audibleVoices;
+        long stolenVoices;
+        float leftGain, rightGain;
+
+        std::vector<Voice> voices;
+        std::vector<int> moving;                    //the voices in attack or release
+        std::vector<double> phases;                 //one for each oscillator, in [0, 1)
+        std::vector<double> increments;
+        std::vector<float> held;                    //for each oscillator, the voices held at 1 (at the beginning of the block)
+        std::vector<float> gains;                   //blockSize for each oscillator: the envelopes of the moving voices
+        std::vector<float> steps;                   //blockSize for each oscillator: the changes of the held voices
+        std::vector<float> weights;                 //for each oscillator, the sum of its gains in the block (0 => silent)
+        std::vector<float> slotGains;               //for each oscillator, its volume at the beginning of the block (0 => stolen or silent)
+        std::vector<float> slotTargets;             //for each oscillator, its volume at the end of the block
+        std::vector<bool> muted;                    //for each oscillator, true if it is audible but stolen
+        std::vector<int> ranking;                   //the audible oscillators, the played ones first
+        std::vector<float> sines;
+        std::vector<float> mono;
+
+        static void sineKernel(float *out, double phase, double increment, int frames);
+        void setGates(const BitBoard &board, int sample);
+        void renderEnvelopes(int from, int to);
+        void selectVoices();
+        void stopVoices(int from);
+
+};
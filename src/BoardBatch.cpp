@@ -0,0 +1,219 @@
+#include "BoardBatch.hpp"
+#include <algorithm>
+#include <bitset>
+#include "LifeKernel.hpp"
+#include "ThreadPool.hpp"
+
+const int BoardBatch::maxWidth;
+const int BoardBatch::lanesPerTask;
+
+BoardBatch::BoardBatch(int _width, int _height, int _count){
+    resize(_width, _height, _count);
+}
+
+/*
+ it changes the size and the number of the boards. All the cells are dead after this call (and all the boards are extinct at generation 0).
+ The boards wider than maxWidth don't fit in a word: the width is clamped (use a BitBoard for them).
+*/
+void BoardBatch::resize(int _width, int _height, int _count){
+    width = std::min(std::max(_width, 0), maxWidth);
+    height = std::max(_height, 0);
+    count = std::max(_count, 0);
+    fields = width > 0 ? maxWidth / width : 1;
+    int boardLanes = (count + fields - 1) / fields;
+    lanes = (boardLanes + lanesPerTask - 1) / lanesPerTask * lanesPerTask;
+    generation = 0;
+
+    boardMask = (width == 64) ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    mask = 0;
+    firstBits = 0;
+    for(int f=0; f<fields && width > 0; f++){
+        mask |= boardMask << (f * width);
+        firstBits |= uint64_t(1) << (f * width);
+    }
+
+    words.assign(size_t(height) * lanes, 0);
+    scratch.assign(words.size(), 0);
+    extinctGenerations.assign(count, 0);
+}
+
+size_t BoardBatch::wordIndex(int index, int y, int &shift) const{
+    int lane = index / fields;
+    shift = (index % fields) * width;
+    return (size_t(lane / lanesPerTask) * height + y) * lanesPerTask + lane % lanesPerTask;
+}
+
+//a board of a different size is not copied
+void BoardBatch::load(int index, const BitBoard &board){
+    if(board.getWidth() != width || board.getHeight() != height) return;
+
+    int population = 0;
+    for(int y=0; y<height; y++){
+        int shift;
+        uint64_t &word = words[wordIndex(index, y, shift)];
+        uint64_t row = board.getRow(y)[0];
+        word = (word & ~(boardMask << shift)) | (row << shift);
+        population += std::bitset<64>(row).count();
+    }
+    extinctGenerations[index] = population == 0 ? generation : -1;
+}
+
+void BoardBatch::store(int index, BitBoard &board) const{
+    board.resize(width, height);
+    for(int y=0; y<height; y++) board.getRow(y)[0] = getRow(index, y);
+}
+
+bool BoardBatch::get(int index, int x, int y) const{
+    int shift;
+    size_t i = wordIndex(index, y, shift);                  //before the read of shift: the order of a single expression's operands is unspecified
+    return (words[i] >> (shift + x)) & 1;
+}
+
+//the extinction is updated immediately: a board filled with set() is not extinct, a board emptied with set() is extinct now
+void BoardBatch::set(int index, int x, int y, bool alive){
+    int shift;
+    uint64_t &word = words[wordIndex(index, y, shift)];
+    uint64_t bit = uint64_t(1) << (shift + x);
+    if(((word & bit) != 0) == alive) return;
+
+    if(alive){
+        word |= bit;
+        extinctGenerations[index] = -1;
+    }
+    else{
+        word &= ~bit;
+        if(getPopulation(index) == 0) extinctGenerations[index] = generation;
+    }
+}
+
+uint64_t BoardBatch::getRow(int index, int y) const{
+    int shift;
+    size_t i = wordIndex(index, y, shift);
+    return (words[i] >> shift) & boardMask;
+}
+
+int BoardBatch::getWidth() const{
+    return width;
+}
+
+int BoardBatch::getHeight() const{
+    return height;
+}
+
+int BoardBatch::getCount() const{
+    return count;
+}
+
+/*
+ STEP
+
+ The rule is selected once for all the boards (see LifeKernel::selectRule()), then every group of lanesPerTask lanes runs all the generations.
+ The groups don't share any word, so they run in parallel without locks.
+*/
+void BoardBatch::step(int generations, const LifeRule &rule, ThreadPool *threadPool){
+    if(generations <= 0 || width == 0 || height == 0 || count == 0) return;
+
+    int groups = lanes / lanesPerTask;
+    LifeKernel::selectRule(rule, [&](const auto &kernelRule){
+        auto stepTask = [&](int group){
+            stepGroup(group, generations, kernelRule);
+        };
+        if(threadPool) threadPool->parallelFor(groups, stepTask);
+        else for(int group=0; group<groups; group++) stepTask(group);
+    });
+    generation += generations;
+}
+
+/*
+ STEPGROUP
+
+ Every generation reads one buffer and writes the other one (the group's block only). After an odd number of generations the block is copied back, so the boards are always in words.
+ The inner loop is the same for every lane (no branches, no carries between the words). The PACMAN effect on the columns is a rotation inside every field:
+    -left neighbours => the word is shifted by 1, and the first column of every field receives the field's last column
+    -right neighbours => the same in the other direction (the bits after the last field are always 0, so nothing enters the last field)
+ The OR of the new rows of every lane tells which boards are empty: the first empty generation is their extinction.
+*/
+template<class Rule>
+void BoardBatch::stepGroup(int group, int generations, const Rule &rule){
+    //local copies: the compiler doesn't have to reload them after every write in the buffers
+    const size_t block = size_t(height) * lanesPerTask;
+    const int shift = width - 1;
+    const uint64_t validBits = mask;
+    const uint64_t leftMask = mask & ~firstBits;
+    const uint64_t rightMask = ~(firstBits << shift);
+    const uint64_t firstColumns = firstBits;
+    const uint64_t lastColumns = firstBits << shift;
+    const uint64_t lowBits = mask & ~lastColumns;
+    uint64_t *current = words.data() + group * block;
+    uint64_t *next = scratch.data() + group * block;
+    uint64_t alive[lanesPerTask];
+
+    //the bit x contains the cell x-1 (left) or x+1 (right) of the same field
+    auto rotateLeft = [=](uint64_t word){
+        return ((word << 1) & leftMask) | ((word >> shift) & firstColumns);
+    };
+    auto rotateRight = [=](uint64_t word){
+        return ((word >> 1) & rightMask) | ((word << shift) & lastColumns);
+    };
+
+    for(int g=0; g<generations; g++){
+        std::fill(alive, alive + lanesPerTask, 0);
+
+        for(int y=0; y<height; y++){
+            /*the famous PACMAN effect (on the rows)*/
+            int up = (y == 0) ? height-1 : y-1;
+            int down = (y == height-1) ? 0 : y+1;
+            const uint64_t *upRow = current + size_t(up) * lanesPerTask;
+            const uint64_t *row = current + size_t(y) * lanesPerTask;
+            const uint64_t *downRow = current + size_t(down) * lanesPerTask;
+            uint64_t *nextRow = next + size_t(y) * lanesPerTask;
+
+            for(int lane=0; lane<lanesPerTask; lane++){
+                uint64_t center[3] = {upRow[lane], row[lane], downRow[lane]};
+                uint64_t left[3] = {rotateLeft(center[0]), rotateLeft(center[1]), rotateLeft(center[2])};
+                uint64_t right[3] = {rotateRight(center[0]), rotateRight(center[1]), rotateRight(center[2])};
+                uint64_t cells = LifeKernel::nextCells(left, center, right, rule) & validBits;
+                nextRow[lane] = cells;
+                alive[lane] |= cells;
+            }
+        }
+        std::swap(current, next);
+
+        //a field is empty if its last bit is 0 after the sum: the other bits + lowBits carry into the last bit only if one of them is 1
+        for(int lane=0; lane<lanesPerTask; lane++){
+            uint64_t emptyFields = ~(((alive[lane] & lowBits) + lowBits) | alive[lane]) & lastColumns;
+            if(emptyFields == 0) continue;
+
+            int first = (group * lanesPerTask + lane) * fields;
+            for(int f=0; f<fields && first + f < count; f++){
+                long &extinct = extinctGenerations[first + f];
+                if(((emptyFields >> (f * width + shift)) & 1) && extinct < 0) extinct = generation + g + 1;
+            }
+        }
+    }
+
+    if(current != words.data() + group * block) std::copy(current, current + block, words.data() + group * block);
+}
+
+//the population is counted when it is asked (one popcount for every row): step() doesn't count the boards that aren't read
+int BoardBatch::getPopulation(int index) const{
+    int population = 0;
+    for(int y=0; y<height; y++) population += std::bitset<64>(getRow(index, y)).count();
+    return population;
+}
+
+//the rules with B0 are not supported: an extinct board stays empty
+bool BoardBatch::isExtinct(int index) const{
+    return extinctGenerations[index] >= 0;
+}
+
+long BoardBatch::getExtinctGeneration(int index) const{
+    return extinctGenerations[index];
+}
+
+//a row of a board is a single word of BitBoard, so the word's index is the row (the same keys of BitBoard)
+uint64_t BoardBatch::getHash(int index) const{
+    uint64_t hash = 0;
+    for(int y=0; y<height; y++) hash ^= BitBoard::wordKey(y, getRow(index, y));
+    return hash;
+}
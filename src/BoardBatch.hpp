@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BitBoard.hpp"
+
+class ThreadPool;
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ BOARDBATCH
+ The BoardBatch class advances many independent small boards at once (the solver's, the generator's and the AI's grids, as big as the levels of levels.txt): all the boards have the same size and the same rule, and they are stepped in lockstep.
+
+ The boards are at most 64 columns wide, so a row of a board fits in a word, and the small boards share the word: a word is split in fields of width bits, one board for every field (8 boards of 8 * 8 cells in a word).
+ A lane is a column of words (the same fields of every row). The lanes are interleaved in groups of lanesPerTask: the row y of all the lanes of a group is contiguous, and a group is a contiguous block of height * lanesPerTask words.
+ A generation computes one row of all the lanes with the same bitwise adders of BitBoard (see LifeKernel::nextCells()), in a loop without branches over contiguous words: every bit is a cell of a board, and the compiler can also put several lanes in a SIMD register.
+ The PACMAN effect is the same of BitBoard (a torus): the columns are rotated inside every field, the rows wrap around.
+
+ Every group runs all the generations before the next one (its rows stay in the cache). The groups can run on a ThreadPool.
+ After every generation a board that has no alive cells is marked extinct (the rules with B0 are not supported, so an empty board stays empty): after step() every board has its extinction's generation, and its population is counted by getPopulation().
+
+ The methods are:
+
+ -BoardBatch() => it creates count dead boards of width * height cells (width from 1 to maxWidth)
+ -resize() => it changes the boards' size and count and kills all the cells
+ -load() => it copies a BitBoard (of the same size) in a board of the batch
+ -store() => it copies a board of the batch in a BitBoard (it is resized)
+ -get() => it returns the state of the cell (x, y) of a board
+ -set() => it sets the state of the cell (x, y) of a board
+ -getRow() => it returns the row y of a board (the cell x is the bit x, like a BitBoard's word)
+ -getWidth() / getHeight() / getCount() => the boards' size and the number of boards
+ -step() => it computes generations generations of all the boards (in parallel if a ThreadPool is passed)
+ -getPopulation() => it returns the alive cells of a board
+ -isExtinct() => it returns true if a board has no alive cells
+ -getExtinctGeneration() => it returns the generation (since the last resize()) when a board became empty, -1 if it isn't empty
+ -getHash() => it returns the same hash of BitBoard::getHash() for a board
+ -stepGroup() => (private) the generations of a group of lanes
+ -wordIndex() => (private) the index of the word with a row of a board (shift is the first bit of the board's field)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class BoardBatch{
+
+    public:
+        static const int maxWidth = 64;
+        static const int lanesPerTask = 64;         //lanes of a group: 64 rows of 64 lanes are 32KB, the group's two buffers stay in the L2 cache
+
+        BoardBatch(int _width = 0, int _height = 0, int _count = 0);
+        void resize(int _width, int _height, int _count);
+        void load(int index, const BitBoard &board);
+        void store(int index, BitBoard &board) const;
+        bool get(int index, int x, int y) const;
+        void set(int index, int x, int y, bool alive);
+        uint64_t getRow(int index, int y) const;
+        int getWidth() const;
+        int getHeight() const;
+        int getCount() const;
+        void step(int generations = 1, const LifeRule &rule = LifeRule::conway(), ThreadPool *threadPool = nullptr);
+        int getPopulation(int index) const;
+        bool isExtinct(int index) const;
+        long getExtinctGeneration(int index) const;
+        uint64_t getHash(int index) const;
+
+    private:
+        int width;
+        int height;
+        int count;
+        int fields;                                 //boards in a word
+        int lanes;                                  //words of a row (the groups' lanes, the last group is padded)
+        uint64_t boardMask;                         //valid bits of a board's row (the first field)
+        uint64_t mask;                              //valid bits of every word (all the fields)
+        uint64_t firstBits;                         //the first column of every field
+        long generation;
+        std::vector<uint64_t> words;                //group after group, a row of lanesPerTask lanes after the other
+        std::vector<uint64_t> scratch;              //the other buffer of the generations
+        std::vector<long> extinctGenerations;
+
+        template<class Rule> void stepGroup(int group, int generations, const Rule &rule);
+        size_t wordIndex(int index, int y, int &shift) const;
+
+};
@@ -0,0 +1,33 @@
+#include "BoardTripleBuffer.hpp"
+
+const int BoardTripleBuffer::freshBit;
+
+BoardTripleBuffer::BoardTripleBuffer() : middle(1){
+    front = 0;
+    back = 2;
+}
+
+//the boards keep their storage when they are resized to 0 * 0, so the first write doesn't allocate
+void BoardTripleBuffer::reserve(int width, int height){
+    for(BitBoard &board : boards){
+        board.resize(width, height);
+        board.resize(0, 0);
+    }
+}
+
+//release: the reader that takes the middle board sees all the copied words
+void BoardTripleBuffer::write(const BitBoard &board){
+    boards[back] = board;
+    back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & ~freshBit;
+}
+
+//the check without the exchange is enough: only this thread clears the fresh bit
+bool BoardTripleBuffer::read(){
+    if(!(middle.load(std::memory_order_relaxed) & freshBit)) return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & ~freshBit;
+    return true;
+}
+
+const BitBoard &BoardTripleBuffer::getBoard() const{
+    return boards[front];
+}
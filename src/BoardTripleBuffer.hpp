@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include "BitBoard.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ BOARDTRIPLEBUFFER
+ The BoardTripleBuffer class passes the grid from one thread (the writer, the game) to another thread (the reader, the audio callback) without locks and without allocations.
+
+ There are 3 boards: the writer owns the back board, the reader owns the front board, and the middle board is the last published one.
+    -write() copies the grid in the back board, then it swaps the back board with the middle one (an atomic exchange of the middle's index, with the "fresh" bit)
+    -read() swaps the front board with the middle one only if the middle is fresh (an atomic exchange too)
+ Both the threads own their board until the next swap, so the reader never sees a half written board, and neither thread ever waits for the other (wait-free). If the writer publishes twice before a read, the reader gets only the newest board.
+
+ The boards are allocated by reserve(), before the reader starts. The copy in write() reuses the back board's storage, so nothing is allocated for a board that fits in the reserved size (and a bigger board is allocated by the writer, never by the reader).
+
+ The methods are:
+
+ -reserve() => it allocates the 3 boards for the biggest grid (it must be called before the threads use the buffer)
+ -write() => (writer) it copies a board and publishes it
+ -read() => (reader) it takes the last published board, it returns false if nothing was published after the last read
+ -getBoard() => (reader) it returns the front board (the last read board, 0 * 0 before the first read)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class BoardTripleBuffer{
+
+    private:
+        static const int freshBit = 4;          //the middle board has been published and not read yet
+
+        BitBoard boards[3];
+        std::atomic<int> middle;                //the middle board's index (| freshBit)
+        int back;                               //the writer's board
+        int front;                              //the reader's board
+
+    public:
+        BoardTripleBuffer();
+        void reserve(int width, int height);
+        void write(const BitBoard &board);
+        bool read();
+        const BitBoard &getBoard() const;
+
+};
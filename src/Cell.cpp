@@ -51,3 +51,16 @@ ofPoint Cell::getPos(){
 bool Cell::isAlive(){
     return alive;
 }
+
+size_t Cell::getMemorySize(){
+    return sizeof(Cell) + colors.capacity() * sizeof(ofColor) + getMeshMemorySize(body.getMesh());
+}
+
+//vertices, normals, texture coordinates, colors and indices stored in the mesh
+size_t Cell::getMeshMemorySize(ofMesh &mesh){
+    return mesh.getNumVertices() * sizeof(ofDefaultVertexType) +
+        mesh.getNumNormals() * sizeof(ofDefaultNormalType) +
+        mesh.getNumTexCoords() * sizeof(ofDefaultTexCoordType) +
+        mesh.getNumColors() * sizeof(ofDefaultColorType) +
+        mesh.getNumIndices() * sizeof(ofIndexType);
+}
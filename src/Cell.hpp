@@ -17,6 +17,8 @@
  -isAlive() => it returns the cell's state
  -setPos() => it sets the cell's position
  -getPos() => it returns the cell's position
+ -getMemorySize() => it returns the bytes used by the cell (the object, its colors and its box's mesh)
+ -getMeshMemorySize() => it returns the bytes used by a mesh
  
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
@@ -39,5 +41,7 @@ class Cell{
         bool isAlive();
         void setPos(ofPoint _pos);
         ofPoint getPos();
+        size_t getMemorySize();
+        static size_t getMeshMemorySize(ofMesh &mesh);
     
 };
@@ -0,0 +1,27 @@
+#include "CellFlyweight.hpp"
+
+//the 2 boxes are colored only once, so giving birth or killing a cell doesn't change any mesh
+void CellFlyweight::setup(int size){
+    deadBody.set(size);
+    aliveBody.set(size);
+    
+    for(int i=0; i<6; i++){
+        deadBody.setSideColor(i, colors[0]);
+        aliveBody.setSideColor(i, colors[1]);
+    }
+}
+
+void CellFlyweight::draw(ofPoint pos, bool alive){
+    ofBoxPrimitive &body = alive ? aliveBody : deadBody;
+    body.setPosition(pos);
+    body.draw();
+}
+
+ofColor CellFlyweight::getColor(bool alive){
+    return alive ? colors[1] : colors[0];
+}
+
+size_t CellFlyweight::getMemorySize(){
+    return sizeof(CellFlyweight) + colors.capacity() * sizeof(ofColor) +
+        Cell::getMeshMemorySize(deadBody.getMesh()) + Cell::getMeshMemorySize(aliveBody.getMesh());
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "ofMain.h"
+#include "Cell.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+ 
+ CELLFLYWEIGHT
+ The CellFlyweight class contains what all the grid's cells have in common: the box geometry and the 2 palette colors.
+ The grid doesn't store a Cell object for every position anymore, only the alive/dead state (see LifeEngine). When a cell is drawn, the shared box is moved in the cell's position and drawn with the right color.
+ The Player and the Rocket are still Cell objects with their own bodies.
+ 
+ The methods are:
+ 
+ -setup() => it creates the 2 shared boxes (one for the dead cells and one for the alive cells)
+ -draw() => it draws a cell in the passed position
+ -getMemorySize() => it returns the bytes used by the flyweight (shared by all the cells)
+ -getColor() => it returns the dead or the alive color
+ 
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class CellFlyweight{
+    
+    private:
+        ofBoxPrimitive deadBody;
+        ofBoxPrimitive aliveBody;
+        vector<ofColor> colors = {ofColor(20, 20, 20), ofColor(159, 0, 55)};     //the same colors of the Cell class: dead, alive
+    
+    public:
+        void setup(int size);
+        void draw(ofPoint pos, bool alive);
+        size_t getMemorySize();
+        ofColor getColor(bool alive);
+    
+};
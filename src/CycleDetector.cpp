@@ -0,0 +1,45 @@
+#include "CycleDetector.hpp"
+
+CycleDetector::CycleDetector(size_t historySize) : hashes(historySize), generations(historySize){
+    reset();
+}
+
+//the ring buffer is not deallocated, only its positions are invalidated
+void CycleDetector::reset(){
+    next = 0;
+    count = 0;
+    period = 0;
+    stableGeneration = -1;
+}
+
+/*
+ The history is searched from the newest hash to the oldest one, so the smallest period is found.
+ After a cycle is found, the next hashes are not added (the cycle doesn't change until reset()).
+*/
+int CycleDetector::add(long generation, uint64_t hash){
+    if(period > 0) return period;
+
+    for(size_t i=1; i<=count; i++){
+        size_t pos = (next + hashes.size() - i) % hashes.size();
+
+        if(hashes[pos] == hash){
+            period = int(generation - generations[pos]);
+            stableGeneration = generations[pos];
+            return period;
+        }
+    }
+
+    hashes[next] = hash;
+    generations[next] = generation;
+    next = (next + 1) % hashes.size();
+    if(count < hashes.size()) count++;
+    return 0;
+}
+
+int CycleDetector::getPeriod() const{
+    return period;
+}
+
+long CycleDetector::getStableGeneration() const{
+    return stableGeneration;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ CYCLEDETECTOR
+ The CycleDetector class finds when a board repeats itself: a still life (period 1) or an oscillator (period P).
+ It doesn't read the boards: it keeps the hashes of the last historySize generations (a ring buffer) and it compares the new hash with them. The hashes are the boards' Zobrist hashes, updated by the engines with the changed words only (see BitBoard::wordKey()).
+
+ If the board of the generation g is the same of the generation g - P, and nothing was set from outside in the meantime, the next generations repeat the same P boards forever. So the board is stable after the generation g - P.
+ A cell set from outside (the rocket's births) breaks the cycle: the history must be reset.
+
+ The methods are:
+
+ -CycleDetector() => it creates the detector with a history of historySize generations (the max period that can be found)
+ -reset() => it deletes the history (and the found cycle)
+ -add() => it adds the hash of a generation, it returns the period if the board repeated (0 otherwise)
+ -getPeriod() => it returns the period of the found cycle (0 if there isn't a cycle)
+ -getStableGeneration() => it returns the first generation of the found cycle (-1 if there isn't a cycle)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class CycleDetector{
+
+    private:
+        std::vector<uint64_t> hashes;           //ring buffer of the last hashes
+        std::vector<long> generations;          //the generation of every hash
+        size_t next;                            //the next position to write in the ring buffer
+        size_t count;                           //the valid positions of the ring buffer
+        int period;
+        long stableGeneration;
+
+    public:
+        CycleDetector(size_t historySize = 256);
+        void reset();
+        int add(long generation, uint64_t hash);
+        int getPeriod() const;
+        long getStableGeneration() const;
+
+};
@@ -1,16 +1,38 @@
 #include "Environment.hpp"
 
-void Environment::setup(vector<vector<Cell>> level){
+void Environment::setup(const BitBoard &level, const LifeRule &rule, bool plane){
     
-    //set the current level's matrix passed by the Game istance
-    lifeMatrix = level;
-    gridSize = lifeMatrix.size();
+    //set the current level's matrix passed by the Game istance (the two boards are allocated only here)
+    planeMode = plane;
+    if(planeMode){
+        sparseEngine.load(level);
+        sparseEngine.setRule(rule);
+        sparseEngine.copyTo(planeView);
+    }
+    else{
+        lifeEngine.load(level);
+        lifeEngine.setRule(rule);
+    }
+    gridWidth = level.getWidth();
+    gridHeight = level.getHeight();
+    cellFlyweight.setup(cellSize);
+    
+    //the instanced grid's shader is loaded only once. If it is not supported, the grid is drawn cell by cell.
+    if(instancedDraw && !instancedGrid.isLoaded()) instancedDraw = instancedGrid.load();
+    if(instancedGrid.isLoaded() && isGridDrawable()){
+        instancedGrid.setup(level.getWidth(), level.getHeight(), cellSize, cellFlyweight.getColor(false), cellFlyweight.getColor(true));
+    }
+    gridChanged = true;
+    boardChanged = true;
+    
+    cycleDetector.reset();
+    checkCycle();                                                   //the generation 0
     
     /*
      Creation of the player at position (gridGame/2, 1, 1) of the grid
      The player is alive after this call.
     */
-    player = Player(ofPoint(floor(gridSize/2) * cellSize*2, cellSize*2, cellSize), cellSize);
+    player = Player(ofPoint(floor(gridWidth/2) * cellSize*2, cellSize*2, cellSize), cellSize);
     
     /*
     Creation of the rocket (in the same player position)
@@ -18,18 +40,21 @@ void Environment::setup(vector<vector<Cell>> level){
     */
     rocket = Rocket(player.getPos(), cellSize);
     
+    rewindBuffer.clear();
+    recordSnapshot();                                               //the generation 0
+    
 }
 /*
 UPDATE
  
- This is the main game's algorithm. It updates the lifeMatrix (if the updateMatrix param is TRUE), then it checks for collisions with enemies and with the walls (this is called before the player.update() because thanks to this we don't see the player going beyond the limits for a split second)
+ This is the main game's algorithm. It updates the grid (if the updateMatrix param is TRUE), then it checks for collisions with enemies and with the walls (this is called before the player.update() because thanks to this we don't see the player going beyond the limits for a split second)
 
  Then, the player and the rocket is updated. After this, this method checks for rocket's collisions. This happens after the rocket update because this algorithm use:
         -the current rocket position to check for collisions
         -the last rocket position (before a collision) to transform the rocket into an enemy cell.
  
  The flow is:
-    1) updates lifeMatrix (if updateMatrix == true)
+    1) updates the grid (if updateMatrix == true)
     2) checks for "player - walls" collisions
     3) checks for "player - enemies" collisions
 
@@ -38,8 +63,11 @@ UPDATE
     5) checks for "rocket - walls" collisions
     6) checks for "rocket - enemies" collisions
  
+    7) stores the generation in the rewind buffer (if updateMatrix == true)
+ 
 */
 void Environment::update(bool updateMatrix){
+    Tracer::Scope trace("Environment::update");
     ofPoint prevRocketPos = rocket.getPos();                          //the rocket pos in the physical world
     ofPoint prevMapRocketPos = prevRocketPos/(cellSize*2);            //the rocket pos in the life matrix
     prevMapRocketPos.x = int(prevMapRocketPos.x);
@@ -78,7 +106,7 @@ void Environment::update(bool updateMatrix){
      if the rocket collides with a wall, it dies, and borns a new cell in the last rocket's pos.
     */
     if(wallsCollision(newRocketPos) && rocket.isAlive() ){
-        lifeMatrix[prevMapRocketPos.x][prevMapRocketPos.y].giveBirth();
+        giveBirth(prevMapRocketPos);
         rocket.kill();
     }
     
@@ -90,25 +118,62 @@ void Environment::update(bool updateMatrix){
      -rocket.getDirection()[0] == 0 => the rocket move in the y direction
     */    
     string mode = abs(rocket.getDirection()[0]) == 1 ? "x" : "y";
-    if(countNeighbours(lifeMatrix, newRocketPos, mode) > 0  && rocket.isAlive()){
-        lifeMatrix[newMapRocketPos.x][newMapRocketPos.y].giveBirth();
+    if(countNeighbours(getBoard(), newRocketPos, mode) > 0  && rocket.isAlive()){
+        giveBirth(newMapRocketPos);
         rocket.kill();
     }
+    
+    if(updateMatrix){
+        recordSnapshot();
+    }
 
 }
 
-//it draws the player, the rocket and the game's grid (with the enemies)
+/*
+ it draws the player, the rocket and the game's grid (with the enemies).
+ With the instanced drawing, the alive/dead states are uploaded to the GPU only if the grid is changed since the last frame.
+*/
 void Environment::draw(){
+    Tracer::Scope trace("Environment::draw");
     
     player.draw();
     rocket.draw();
     
-    for(int x=0; x<lifeMatrix.size(); x++){
-        for(int y=0; y<lifeMatrix[0].size(); y++){
-            lifeMatrix[x][y].draw();
+    if(instancedDraw && isGridDrawable()){
+        if(gridChanged){
+            instancedGrid.update(getBoard());
+            gridChanged = false;
         }
+        instancedGrid.draw();
+        return;
     }
     
+    const BitBoard &board = getBoard();
+    if(!isGridDrawable()){
+        //a huge grid: only the alive cells are drawn (the dead words are skipped 64 cells at a time)
+        for(int y=0; y<board.getHeight(); y++){
+            const uint64_t *row = board.getRow(y);
+            for(int i=0; i<board.getWordsPerRow(); i++){
+                if(row[i] == 0) continue;
+                for(int bit=0; bit<64; bit++){
+                    if((row[i] >> bit) & 1) cellFlyweight.draw(ofPoint((i * 64 + bit) * cellSize*2, y * cellSize*2, cellSize), true);
+                }
+            }
+        }
+        return;
+    }
+    
+    for(int x=0; x<board.getWidth(); x++){
+        for(int y=0; y<board.getHeight(); y++){
+            cellFlyweight.draw(ofPoint(x * cellSize*2, y * cellSize*2, cellSize), board.get(x, y));
+        }
+    }
+    
+}
+
+//the grids with too many cells are not drawn instanced and their dead cells are not drawn
+bool Environment::isGridDrawable(){
+    return long(gridWidth) * gridHeight <= InstancedGrid::maxCells;
 }
 
 /*
@@ -120,43 +185,81 @@ void Environment::draw(){
      - Each alive cell with two or three neighbors survives.
      - Each dead cell with three neighbors becomes populated.
  
-  The method uses a copy of the original lifeMatrix, because if we change directly values in the orginal matrix, the algorithm doesn't work as expected.
+  The rules are computed by the BitBoard class 64 cells at a time (see BitBoard::nextGeneration()), without copying the grid: the LifeEngine swaps two preallocated boards.
 */
 void Environment::gameOfLifeEngine(){
-    vector<vector<Cell>> matrix = lifeMatrix;
-    
-    for(int x=0; x<matrix.size(); x++){
-        for(int y=0; y<matrix[0].size(); y++){
-            int currentNeighbors = countNeighbours(matrix, ofPoint(x*cellSize*2, y*cellSize*2));
-            
-            if(matrix[x][y].isAlive() && currentNeighbors <= 1){
-                lifeMatrix[x][y].kill();
-            }
-            else if(matrix[x][y].isAlive() && currentNeighbors >= 4){
-                lifeMatrix[x][y].kill();
-            }
-            else if(matrix[x][y].isAlive() && (currentNeighbors == 2 || currentNeighbors == 3)){
-                lifeMatrix[x][y].giveBirth();   //it is altready alive...
-            }
-            else if(!matrix[x][y].isAlive() && currentNeighbors == 3){
-                lifeMatrix[x][y].giveBirth();
-            }
-        }
+    Tracer::Scope trace("Environment::gameOfLifeEngine");
+    if(planeMode){
+        sparseEngine.step();
+        sparseEngine.copyTo(planeView);                     //the level's area is the visible part of the plane
+        gridChanged = true;
+        boardChanged = true;
+        checkCycle();
+        return;
+    }
+    
+    long prevAllocations = lifeEngine.getAllocationCount();
+    lifeEngine.step();
+    gridChanged = true;
+    if(lifeEngine.getStats().births + lifeEngine.getStats().deaths > 0) boardChanged = true;
+    
+    //debug: a generation must not allocate anything
+    if(lifeEngine.getAllocationCount() != prevAllocations){
+        ofLogWarning() << "The generation step allocated memory (allocations: " << lifeEngine.getAllocationCount() << ")" << endl;
     }
+    checkCycle();
+}
+
+/*
+ CHECKCYCLE
+ 
+ If the grid's hash was already seen, the grid is periodic from now on: the LifeEngine records one period and then replays it (on the plane the generations are still computed, the chunks are only the alive ones).
+*/
+void Environment::checkCycle(){
+    if(cycleDetector.getPeriod() > 0) return;
+    
+    const GenerationStats &stats = getGenerationStats();
+    int period = cycleDetector.add(stats.generation, stats.hash);
+    if(period > 0){
+        ofLogNotice() << "The grid is stable after " << cycleDetector.getStableGeneration() << " generations (period " << period << ")" << endl;
+        if(!planeMode) lifeEngine.cacheCycle(period);
+    }
+}
+
+int Environment::getCyclePeriod(){
+    return cycleDetector.getPeriod();
+}
+
+long Environment::getStableGeneration(){
+    return cycleDetector.getStableGeneration();
+}
+
+//it gives birth to an enemy cell in the passed matrix position (the rocket becomes an enemy)
+void Environment::giveBirth(ofPoint mapPos){
+    if(planeMode){
+        sparseEngine.set(mapPos.x, mapPos.y, true);
+        planeView.set(mapPos.x, mapPos.y, true);
+    }
+    else{
+        lifeEngine.set(mapPos.x, mapPos.y, true);
+    }
+    gridChanged = true;
+    boardChanged = true;
+    cycleDetector.reset();                                  //the grid changed from outside: the old hashes can't predict the next generations
 }
 
 //if the player's position fits with an enemy's position, it returns true, otherwise false
 bool Environment::playerCollision(ofPoint cell){
     ofPoint currentPos = cell/(cellSize*2);                   //map the player pos to the matrix index
     
-    if(lifeMatrix[currentPos.x][currentPos.y].isAlive()) return true;
+    if(getBoard().get(currentPos.x, currentPos.y)) return true;
     return false;
 }
 
 //if the passed position is outside the grid, returns true, otherwise false.
 bool Environment::wallsCollision(ofPoint cell){
-    if( (cell.y < 0 || cell.y > gridSize*cellSize*2 - cellSize) ||      // *2 because the grid has spaces
-        (cell.x < 0 || cell.x > gridSize*cellSize*2 - cellSize) ){
+    if( (cell.y < 0 || cell.y > gridHeight*cellSize*2 - cellSize) ||    // *2 because the grid has spaces
+        (cell.x < 0 || cell.x > gridWidth*cellSize*2 - cellSize) ){
         return true;
     }
     return false;
@@ -165,64 +268,33 @@ bool Environment::wallsCollision(ofPoint cell){
 /*
  It counts the neighbors of a given grid position.
  If mode is setted to x or y, only the neighbors in the x or y direction is taken in consideration.
+ The counting is done by the board (see BitBoard::countNeighbours()): with the PACMAN effect on the torus, without it on the plane (the cells outside the level's area are not visible).
 */
-int Environment::countNeighbours(vector<vector<Cell>> &matrix, ofPoint _pos, string _mode){
-    
-    int count = 0;
+int Environment::countNeighbours(const BitBoard &board, ofPoint _pos, string _mode){
     ofPoint currentPos = _pos/(cellSize*2);     //map the pos to matrix's indexes
-    int fromX, fromY, toX, toY;
-    
-    if(_mode == "x"){               //if the mode is "x", the loop goes from -1 to 2 inly in the x direction
-        fromX = -1;
-        fromY = 0;
-        toX = 2;
-        toY = 1;
-    }
-    else if(_mode == "y"){          //if the mode is "y", the loop goes from -1 to 2 inly in the y direction
-        fromX = 0;
-        fromY = -1;
-        toX = 1;
-        toY = 2;
-    }
-    else{                           //otherwise neighbors are checked in both directions
-        fromX = -1;
-        fromY = -1;
-        toX = 2;
-        toY = 2;
-    }
+    bool horizontal = _mode != "y";
+    bool vertical = _mode != "x";
     
-    for(int x=fromX; x<toX; x++){
-        for(int y=fromY; y<toY; y++){
-            
-            ofPoint neighborPos = ofPoint(currentPos.x + x, currentPos.y + y);
-            if((neighborPos.x == currentPos.x) && (neighborPos.y == currentPos.y) ) continue; //the current cell is not calculated as a neighbour
-            
-            /*the famous PACMAN effect*/
-            if(neighborPos.x < 0) neighborPos.x = gridSize-1;
-            if(neighborPos.y < 0) neighborPos.y = gridSize-1;
-            if(neighborPos.x >= gridSize) neighborPos.x = 0;
-            if(neighborPos.y >= gridSize) neighborPos.y = 0;
-            
-            //if this cell is alive (is an enemy), increments the count var
-            if(matrix[int(neighborPos.x)][int(neighborPos.y)].isAlive()) count++;
-            
-        }
-    }
-    return count;
-
+    return board.countNeighbours(int(currentPos.x), int(currentPos.y), horizontal, vertical, !planeMode);
 }
 
-/* utility: it counts the alive cells (we can use also a class attribute, without call every time a method), but I use this method because the code is probably clearer.
+/* utility: it returns the alive cells. The engines count them while they compute the generations (and when the rocket gives birth to a cell), so this is O(1).
+ On the plane all the alive cells are counted, also the ones outside the level's area: the level is won only when the whole plane is empty (a glider that flies away must be shot down).
 */
 int Environment::countAliveCells(){
-    int aliveCells = 0;
-    for(int x=0; x<lifeMatrix.size(); x++){
-        for(int y=0; y<lifeMatrix[0].size(); y++){
-            if(lifeMatrix[x][y].isAlive()) aliveCells++;
-        }
-    }
-    return aliveCells;
-    
+    if(planeMode) return int(sparseEngine.countAlive());
+    return lifeEngine.countAlive();
+}
+
+const GenerationStats &Environment::getGenerationStats(){
+    if(planeMode) return sparseEngine.getStats();
+    return lifeEngine.getStats();
+}
+
+//the board of the level's area: the LifeEngine's current generation, or the visible part of the plane
+const BitBoard &Environment::getBoard(){
+    if(planeMode) return planeView;
+    return lifeEngine.getBoard();
 }
 
 //pass events to the player and the rocket
@@ -235,23 +307,122 @@ void Environment::control(string control){
     
 }
 
-/*TODO: I could pass it as a pointer...*/
-//a boolean's matrix is used in the Soundtrack class. Boolean represent the cell's state: alive/dead.
-vector<vector<bool>> Environment::getBoolLifeMatrix(){
-    vector<vector<bool>> boolMatrix;
-    for(int x=0; x<lifeMatrix.size(); x++){
-        boolMatrix.push_back(vector<bool>());
-        for(int y=0; y<lifeMatrix[0].size(); y++){
-            boolMatrix[x].push_back(lifeMatrix[x][y].isAlive() ? true : false);
-        }
-    }
-    return boolMatrix;
+//the board is passed to the Soundtrack class (alive/dead cells) only if a cell was born or died since the last call
+const BitBoard *Environment::getChangedBoard(){
+    if(!boardChanged) return nullptr;
+    
+    boardChanged = false;
+    return &getBoard();
 }
 
 int Environment::getCellSize(){
     return cellSize;
 }
 
+long Environment::getAllocationCount(){
+    return lifeEngine.getAllocationCount();
+}
+
+size_t Environment::getMemorySize(){
+    if(planeMode) return sparseEngine.getMemorySize() + planeView.getMemorySize() + cellFlyweight.getMemorySize();
+    return lifeEngine.getMemorySize() + rewindBuffer.getMemorySize() + rewindBoard.getMemorySize() + cellFlyweight.getMemorySize();
+}
+
+//the instanced drawing can be enabled only if its shader is loaded
+void Environment::toggleInstancedDraw(){
+    instancedDraw = !instancedDraw && instancedGrid.isLoaded();
+    gridChanged = true;
+}
+
+/*
+ SKIPGENERATIONS
+ 
+ It jumps ahead n generations (the player and the rocket don't move). It is used for the levels' previews.
+ HashLife gives the same result of the game only on power of 2 square levels (see HashLifeEngine), the other levels are advanced generation by generation.
+ On the plane the chunks are advanced generation by generation (only the alive chunks are computed).
+*/
+void Environment::skipGenerations(long generations){
+    if(planeMode){
+        sparseEngine.advance(generations);
+        sparseEngine.copyTo(planeView);
+        gridChanged = true;
+        boardChanged = true;
+        cycleDetector.reset();
+        checkCycle();
+        return;
+    }
+    
+    BitBoard board;
+    lifeEngine.copyTo(board);
+    
+    HashLifeEngine hashLife;
+    hashLife.setRule(lifeEngine.getRule());
+    hashLife.load(board);
+    
+    if(hashLife.isTorus()){
+        hashLife.advance(generations);
+        hashLife.copyTo(board);
+        
+        GenerationStats stats;                              //the engine continues from the skipped generation (the births and deaths of the jump are not known)
+        stats.generation = lifeEngine.getStats().generation + generations;
+        stats.population = board.countAlive();
+        stats.hash = board.getHash();
+        lifeEngine.restore(board, stats);
+    }
+    else{
+        lifeEngine.advance(generations);
+    }
+    gridChanged = true;
+    boardChanged = true;
+    cycleDetector.reset();                                  //the skipped generations are not in the history
+    checkCycle();
+}
+
+//the snapshot is taken after the player and the rocket moved, so a rewind restores a consistent frame
+void Environment::recordSnapshot(){
+    Tracer::Scope trace("Environment::recordSnapshot");
+    if(planeMode) return;
+    rewindBuffer.record(lifeEngine.getBoard(), lifeEngine.getStats(), player.getState(), rocket.getState());
+}
+
+/*
+ REWIND
+ 
+ The grid goes back n generations (or to the oldest stored one), with its stats. The player and the rocket go back to their positions of that generation.
+ The newer generations are deleted from the rewind buffer, the game continues from the restored one.
+*/
+bool Environment::rewind(int generations){
+    if(planeMode || rewindBuffer.size() < 2 || generations <= 0) return false;
+    
+    generations = min(generations, int(rewindBuffer.size()) - 1);
+    const RewindBuffer::Snapshot *snapshot = rewindBuffer.rewind(generations, rewindBoard);
+    lifeEngine.restore(rewindBoard, snapshot->stats);
+    player.setState(snapshot->player);
+    rocket.setState(snapshot->rocket);
+    
+    gridChanged = true;
+    boardChanged = true;
+    cycleDetector.reset();                                  //the history is in the future now
+    checkCycle();
+    return true;
+}
+
+ofPoint Environment::getPlayerDirection(){
+    return player.getDirection();
+}
+
+//the world position is cell * cellSize * 2 (the same conversion of update())
+GameModel::Actor Environment::getPlayerCell(){
+    ofPoint cell = player.getPos() / (cellSize*2);
+    ofPoint direction = player.getDirection();
+    GameModel::Actor actor;
+    actor.x = int(cell.x);
+    actor.y = int(cell.y);
+    actor.dirX = int(round(direction.x));
+    actor.dirY = int(round(direction.y));
+    return actor;
+}
+
 bool Environment::isPlayerAlive(){
     return player.isAlive();
 }
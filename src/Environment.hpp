@@ -1,6 +1,15 @@
 #pragma once
 #include "ofMain.h"
 #include "Cell.hpp"
+#include "CellFlyweight.hpp"
+#include "InstancedGrid.hpp"
+#include "LifeEngine.hpp"
+#include "HashLifeEngine.hpp"
+#include "SparseLifeEngine.hpp"
+#include "CycleDetector.hpp"
+#include "RewindBuffer.hpp"
+#include "GameModel.hpp"
+#include "Tracer.hpp"
 #include "Player.hpp"
 #include "Rocket.hpp"
 
@@ -12,40 +21,94 @@
  
  The methods are:
  
- -setup() => it initializes the environment, the player and the rocket
+ -setup() => it initializes the environment (with the level's rule and board mode), the player and the rocket
  -update() => it updates the grid, the rocket and the player and checks for collisions
  -draw() => it draws the grid, the player and the rocket
- -gameOfLifeEngine() => Conway's Game of Life rules
+ -gameOfLifeEngine() => the level's rules (Conway's Game of Life by default, computed on the bit-packed board)
  -countNeighbours() => it counts a cell's neighbors
  -control() => it handles the rocket's and player's commands
  -wallsCollision() => it checks for walls collisions
  -playerCollision() => it checks for player collisions
- -countAliveCells() => it counts the matrix's alive cells
+ -countAliveCells() => it returns the matrix's alive cells (kept up to date by the LifeEngine, without scanning the grid)
+ -getGenerationStats() => it returns the stats of the last generation (population, births and deaths)
  -getCellSize() => it returns the cell's size
- -getBoolLifeMatrix() => it doesn't return the Cell's matrix, but a boolean's matrix (alive/dead cells)
+ -getChangedBoard() => it returns the board for the soundtrack, or nullptr if the grid didn't change since the last call
+ -giveBirth() => it gives birth to an enemy cell
+ -getBoard() => it returns the board of the level's area (the current generation)
+ -getCyclePeriod() => it returns the period of the grid's cycle (1 => still life, 0 => the grid is not periodic yet)
+ -getStableGeneration() => it returns the generation after which the grid is periodic (-1 if it is not periodic yet)
+ -checkCycle() => it adds the current generation's hash to the cycle detector
+ -isGridDrawable() => it returns false if the grid is too big for the instanced drawing (and for drawing the dead cells)
+ -getAllocationCount() => debug counter: how many times the simulation's boards have been allocated
+ -getMemorySize() => it returns the bytes used by the grid (the boards, the rewind buffer and the shared cell's flyweight)
+ -toggleInstancedDraw() => it switches between the instanced drawing (one draw call) and the cell by cell drawing
+ -skipGenerations() => it jumps ahead n generations (level preview), with HashLife when the PACMAN effect allows it
+ -rewind() => it goes back n generations (the grid, the player and the rocket), it returns false if there isn't anything to rewind
+ -getPlayerDirection() => it returns the player's direction (the Game rotates the camera with it after a rewind)
+ -getPlayerCell() => it returns the player's cell and direction in the life matrix (the hint engine's state)
+ -recordSnapshot() => it stores the current generation in the rewind buffer
+ 
+ The grid can be rectangular (width * height). The grids with more cells than InstancedGrid::maxCells are too big for the instance buffer: only their alive cells are drawn, cell by cell.
+ 
+ There are 2 board modes:
+    -torus => the level's board has the PACMAN effect (LifeEngine)
+    -plane => the level is the starting area of an unbounded plane (SparseLifeEngine): the patterns can leave the area and they don't fill the memory. Only the level's area is drawn and collides with the player and the rocket (planeView).
+ 
+ The grid's Zobrist hash (updated by the engines with the births and the deaths) is checked by the cycleDetector after every generation: when the grid repeats itself, the LifeEngine replays the cycle instead of computing it. A rocket's birth breaks the cycle.
+ 
+ After every generation the grid, the player and the rocket are stored in the rewindBuffer (deltas of the previous generation, see RewindBuffer), so the game can go back some hundreds of generations without loading the level again. The rewind is available only with the PACMAN effect: the plane's cells outside the level's area are not stored.
+ 
+ The state of the enemies is stored in lifeEngine (1 bit for each cell, double buffered). There are no Cell objects for the grid: every cell is drawn with the shared cellFlyweight, or the whole grid is drawn with one instanced draw call (instancedGrid) if the GPU supports it.
  
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
 class Environment{
     private:
         const int cellSize = 1;                                     //size of a cell
-        int gridSize;                                               //size n of the n * n matrix
-        vector<vector<Cell>> lifeMatrix;                            //the game's grid
+        int gridWidth;                                              //size of the width * height matrix
+        int gridHeight;
+        LifeEngine lifeEngine;                                      //the game's grid (alive/dead cells)
+        SparseLifeEngine sparseEngine;                              //the game's grid in the plane mode
+        BitBoard planeView;                                         //the level's area of the plane (copied after every generation)
+        bool planeMode = false;
+        CycleDetector cycleDetector;                                //it finds when the grid repeats itself
+        RewindBuffer rewindBuffer;                                  //the last generations (torus mode only)
+        BitBoard rewindBoard;                                       //the board restored by a rewind (reused)
+        CellFlyweight cellFlyweight;                                //box and colors shared by all the grid's cells
+        InstancedGrid instancedGrid;                                //the grid drawn with one draw call
+        bool instancedDraw = true;                                  //false if the instanced grid is disabled or not supported
+        bool gridChanged;                                           //true if the instanced grid's states must be uploaded again
+        bool boardChanged;                                          //true if the board must be passed to the soundtrack again
         Player player = Player(ofPoint(0, 0, cellSize), cellSize);
         Rocket rocket = Rocket(ofPoint(0, 0, cellSize), cellSize);
     
         bool wallsCollision(ofPoint cell);
         bool playerCollision(ofPoint cell);
         void gameOfLifeEngine();
-        int countNeighbours(vector<vector<Cell>> &matrix, ofPoint _pos, string _mode="xy");
+        int countNeighbours(const BitBoard &board, ofPoint _pos, string _mode="xy");
+        void giveBirth(ofPoint mapPos);
+        bool isGridDrawable();
+        void checkCycle();
+        void recordSnapshot();
     
     public:
-        void setup(vector<vector<Cell>> level);
+        void setup(const BitBoard &level, const LifeRule &rule = LifeRule::conway(), bool plane = false);
         void update(bool updateMatrix);
         void draw();
         void control(string control);
         int countAliveCells();
+        const GenerationStats &getGenerationStats();
         int getCellSize();
         bool isPlayerAlive();
-        vector<vector<bool>> getBoolLifeMatrix();
+        const BitBoard *getChangedBoard();
+        long getAllocationCount();
+        size_t getMemorySize();
+        void toggleInstancedDraw();
+        void skipGenerations(long generations);
+        int getCyclePeriod();
+        long getStableGeneration();
+        bool rewind(int generations);
+        ofPoint getPlayerDirection();
+        GameModel::Actor getPlayerCell();
+        const BitBoard &getBoard();
 };
@@ -116,7 +116,10 @@ void GUI::drawTexts(){
     else{
         font.drawString(title, screenWidth/2 - font.stringWidth(title)/2, margin*3);
         font.drawString(level, screenWidth/2 - font.stringWidth(level)/2, margin*6);
+        font.drawString(stats, screenWidth/2 - font.stringWidth(stats)/2, margin*7);
         font.drawString(message, screenWidth/2 - font.stringWidth(message)/2, margin*8);
+        font.drawString(audioStats, screenWidth/2 - font.stringWidth(audioStats)/2, margin*9);
+        font.drawString(audioHistogram, screenWidth/2 - font.stringWidth(audioHistogram)/2, margin*18);     //under the buttons
     }
 
 }
@@ -142,6 +145,27 @@ void GUI::setLevel(string _level){
     level = "Level " + _level;
 }
 
+//it sets the stats of the last generation. If the grid is periodic (period > 0), it says after how many generations it became stable
+void GUI::setStats(const GenerationStats &_stats, long stableGeneration, int period){
+    stats = "Generation " + ofToString(_stats.generation) + ": " + ofToString(_stats.population) + " cells (+" + ofToString(_stats.births) + " -" + ofToString(_stats.deaths) + ")";
+    if(period > 0) stats += ", stable after " + ofToString(stableGeneration) + " generations (period " + ofToString(period) + ")";
+}
+
+//it sets the audio callbacks' stats: the mean and the worst time against the buffer's deadline, and the histogram of the loads (only the used buckets)
+void GUI::setAudioStats(const AudioMonitor::Report &report){
+    if(report.callbacks == 0){
+        audioStats = "";
+        audioHistogram = "";
+        return;
+    }
+    audioStats = "Audio: " + ofToString(report.callbacks) + " callbacks, mean " + ofToString(report.meanDuration / 1000, 2) + " ms, worst " + ofToString(report.worstDuration / 1000, 2)
+        + " ms of " + ofToString(report.deadline / 1000, 2) + " ms (" + ofToString(report.worstLoad * 100, 0) + "%), " + ofToString(report.overruns) + " overruns";
+    audioHistogram = "Load:";
+    for(int b=0; b<AudioMonitor::buckets; b++){
+        if(report.histogram[b] > 0) audioHistogram += " " + string(AudioMonitor::bucketName(b)) + " " + ofToString(report.histogram[b]);
+    }
+}
+
 void GUI::windowResized(ofResizeEventArgs & resize){
     screenWidth = ofGetWindowWidth();
     screenHeight = ofGetWindowHeight();
@@ -1,6 +1,8 @@
 #pragma once
 #include "ofMain.h"
 #include "ofxGui.h"
+#include "LifeEngine.hpp"
+#include "AudioMonitor.hpp"
 
 /*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
  GUI
@@ -21,6 +23,8 @@
  -buttonsPosition() => it positions the buttons
  -setMessage() => it sets a message passed by another class
  -setLevel() => it sets the level message
+ -setStats() => it sets the stats message (generation, alive cells, births and deaths, and when the grid became stable)
+ -setAudioStats() => it sets the audio messages (the callbacks' load against their deadline, the overruns and the load's histogram)
  
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
@@ -42,6 +46,9 @@ class GUI{
         string title;
         string message;
         string level;
+        string stats;
+        string audioStats;
+        string audioHistogram;
         string rulesText;
         ofTrueTypeFont font;
         const int margin = 20;
@@ -64,5 +71,7 @@ class GUI{
         void draw();
         void setMessage(string _message);
         void setLevel(string _level);
+        void setStats(const GenerationStats &_stats, long stableGeneration = -1, int period = 0);
+        void setAudioStats(const AudioMonitor::Report &report);
         void windowResized(ofResizeEventArgs & resize);
 };
@@ -1,9 +1,10 @@
 #include "Game.hpp"
 
-void Game::setup(){
+void Game::setup(int sampleRate){
     logFileName = "log.txt";
     pause = true;
     musicOn = true;
+    hintOn = false;
     //delay = 240;
     time = 1;                                   //1, so the level doesn't update immediately
     isRotationEnabled = true;
@@ -13,6 +14,16 @@ void Game::setup(){
     ofLogToFile(logFileName, true);
     levelIndx = -1;                             //the init level is -1, but becomes 0 when I call nextLevel()
     loadLevels();
+    logMemoryReport();
+    
+    //the soundtrack's keyboard and boards are allocated for the biggest level, before the sound stream starts (see ofApp::setup())
+    int maxWidth = 0, maxHeight = 0;
+    for(const BitBoard &level : levels){
+        maxWidth = max(maxWidth, level.getWidth());
+        maxHeight = max(maxHeight, level.getHeight());
+    }
+    soundtrack.setup(maxWidth, maxHeight);
+    audioMonitor.setup(sampleRate);
     
     //pause and musicOn vars are passed by reference. These values are directly changeable from the GUI.
     gui.setup(pause, musicOn);
@@ -46,6 +57,14 @@ UPDATE
  
 */
 void Game::update() {
+    Tracer::Scope trace("Game::update");
+    
+    //the previewed generations are not played: the level restarts from its beginning
+    if (!pause && previewGeneration > 0) {
+        previewGeneration = 0;
+        gui.setMessage("");
+        repeatLevel();
+    }
     
     if (!pause) {
         if (environment.isPlayerAlive()) {
@@ -54,7 +73,7 @@ void Game::update() {
              every 240 cycles.*/
             if (time % delay == 0) {
                 time = 0;                                               //with this, time does not grow too much...
-                int aliveCells = environment.countAliveCells();
+                int aliveCells = environment.countAliveCells();        //O(1): the population is counted by the generation step
                 
                 //if the level is finished and is not the last level
                 if (aliveCells == 0 && levelIndx < levels.size() - 1) {
@@ -71,9 +90,15 @@ void Game::update() {
                 else {
                     environment.update(true);          //the enemies's position (or rather the game's matrix) is updated with the TRUE parameter
                     gui.setMessage("");
+                    gui.setStats(environment.getGenerationStats(), environment.getStableGeneration(), environment.getCyclePeriod());
+                    updateHint();                      //the hint's search restarts from the new grid (on its own thread)
                     
                     /*if the musicOn var is true, the game matrix is passed to the Soundtrack class, that treats it like a kind of Keyboard (or rather a sequencer)*/
-                    if (musicOn) soundtrack.setMatrix(environment.getBoolLifeMatrix());
+                    if (musicOn) {
+                        Tracer::Scope trace("Game::soundtrackHandoff");
+                        const BitBoard *board = environment.getChangedBoard();
+                        if(board) soundtrack.setBoard(*board);
+                    }
                 }
             }
             else {
@@ -105,21 +130,26 @@ void Game::update() {
     //if the pause var is TRUE
     } else {
         gui.update();
+        gui.setAudioStats(audioMonitor.getReport());
     }
     
+    logAudioSpikes();
+    
 }
 
 
 void Game::draw(){
+    Tracer::Scope trace("Game::draw");
     
     if(!pause){
         ofHideCursor();                                 //hide the cursor during the game
         ofPushMatrix();
         
         ofRotateZDeg(angle);                            //rotate angle° around the Z axis (the axis "vertical" to the grid)
-        ofTranslate(-gameSize/2, -gameSize/2);          //center the environment (the rotation happens in the (0,0,0) )
+        ofTranslate(-gameWidth/2, -gameHeight/2);       //center the environment (the rotation happens in the (0,0,0) )
         
         environment.draw();
+        if(hintOn && !levelsPlanes[levelIndx]) drawHint();
         
         ofPopMatrix();
     }
@@ -135,6 +165,7 @@ void Game::draw(){
  
  */
 void Game::drawGUI(){
+    Tracer::Scope trace("Game::drawGUI");
     if(pause){
         gui.draw();
     }
@@ -151,6 +182,12 @@ KEYPRESSED
     -RIGHT => right arrow or D
     -SPACE => spacebar
     -PAUSE => p
+    -REWIND => z (it goes back rewindGenerations generations)
+    -TRACING on/off => t (debug, the frame's phases are recorded)
+    -TRACE DUMP => T (debug, the last traceSeconds seconds are written in a chrome://tracing JSON file)
+    -HINTS on/off => h (the best next shot is drawn on the grid)
+    -PREVIEW => f (only in pause, it skips previewGenerations generations of the level)
+    -INSTANCED DRAWING on/off => i (debug)
  
  */
  void Game::keyPressed(ofKeyEventArgs& eventArgs){
@@ -182,11 +219,46 @@ KEYPRESSED
                 }
             }
             if(key == 32) environment.control("space");
+            
+            //the camera follows the restored player's direction: (0, 1) => 0°, (1, 0) => 90°, (-1, 0) => -90°, (0, -1) => 180°
+            if(key == 122 && environment.rewind(rewindGenerations)){
+                ofPoint dir = environment.getPlayerDirection();
+                if(isRotationEnabled) angle = int(round(ofRadToDeg(atan2(dir.x, dir.y))));
+                prevAngle = angle;
+                updateHint();
+            }
         }
     }
     
     if(key == 112){         // "p" (pause) key
         pause = !pause;
+        if(pause) logAudioReport();
+    }
+    
+    if(key == 102 && pause){    // "f" (preview) key
+        previewLevel();
+    }
+    
+    if(key == 104){         // "h" key
+        hintOn = !hintOn;
+        if(hintOn) updateHint();
+        else hintEngine.stop();
+    }
+    
+    if(key == 105){         // "i" key
+        environment.toggleInstancedDraw();
+    }
+    
+    if(key == 116){         // "t" key
+        Tracer::setEnabled(!Tracer::isEnabled());
+        if(Tracer::isEnabled()) Tracer::setThreadName("main");
+        ofLogNotice() << "Tracing " << (Tracer::isEnabled() ? "on" : "off") << endl;
+    }
+    
+    if(key == 84){          // "T" key
+        string tracePath = ofToDataPath("trace-" + ofGetTimestampString() + ".json", true);
+        if(Tracer::dump(tracePath, traceSeconds)) ofLogNotice() << "Trace written in " << tracePath << endl;
+        else ofLogError() << "The trace can't be written in " << tracePath << endl;
     }
     
 }
@@ -197,127 +269,77 @@ KEYPRESSED
  
     This method:
     1) loads the txt data
-    2) parses the data with the levelParser() method
-    3) checks for some common errors in these matrices with the levelChecker() method
+    2) parses the data with the levelParser() method (the levels are already bit boards, 1 bit for each cell)
+    3) checks for some common errors in these boards with the levelChecker() method
     4) sets only the valid levels, return a 1*1 grid if all the levels are not valid (or the file is not present)
  
      Checks:
         -does the file exist? (loadLevels method)
         -are the level's header correct? (levelsParser method)
         -are the matrix's numbers valid? (0 or 1) (levelsParser method)
-        -are the levels square shaped? (levelChecker)
+        -are the levels rectangular and not bigger than 16384x16384? (levelsParser and levelChecker methods)
         -are the levels non empty (with at least one "1")? (levelChecker method)
  
  */
 void Game::loadLevels(){
-    vector<vector<vector<Cell>>> loadedLevels;
-    vector<vector<vector<Cell>>> validLevels;               //if there is errors, this will contains only the valid levels
-    vector<int> validSpeeds;                                //speeds share the same level's index, so if it changes, it must be changed also the speed indexes
-
-    bool isValid = true;                                    //if any level is not valid this will be false
+    vector<LevelParser::Level> loadedLevels;
     
     ofBuffer buffer = ofBufferFromFile("levels.txt");       //fetches the data from the levels.txt file
     
-    loadedLevels = levelsParser(buffer);                    //parses the txt file, returns a matrix for each level
-    
-    if(loadedLevels.size() == 0){                           //if the file isn't correctly parsed, create a 1*1 game's grid
-        isValid = false;
-        levelsSpeeds.clear();
-        levelsSpeeds.push_back(240);                        //default delay
-        int cellSize = environment.getCellSize();
-        Cell newCell = Cell(ofPoint(0, 0, cellSize), cellSize);
-        validLevels.push_back(vector<vector<Cell>>());
-        validLevels[0].push_back(vector<Cell>());
-        validLevels[0][0].push_back(newCell);
+    loadedLevels = levelsParser(buffer);                    //parses the txt file, returns a bit board for each level
+    
+    levels.clear();
+    levelsSpeeds.clear();                                   //speeds and rules share the same level's index
+    levelsRules.clear();
+    levelsPlanes.clear();
+    
+    for(int l=0; l<loadedLevels.size(); l++){
+        string tempError = levelChecker(loadedLevels[l].board);     //checks if the data is well structured for each level
         
-        ofLogError() << "File levels.txt missing. Check in the data folder." << endl;
-    }
-    else{                                                  //if the file is correctly parsed
-        string tempError = "";
-        for(int l=0; l<loadedLevels.size(); l++){
-            tempError = levelChecker(loadedLevels[l]);       //checks if the data is well structured for each level
-            
-            if(tempError != ""){
-                isValid = false;
-                ofLogError() << tempError << " (level index:  " << l << ")" << endl;
-            }
-            else{
-                validLevels.push_back(loadedLevels[l]);         //contains only the valid levels
-                validSpeeds.push_back(levelsSpeeds[l]);
-            }
+        if(tempError != ""){
+            ofLogError() << tempError << " (level index:  " << l << ")" << endl;
+        }
+        else{
+            levels.push_back(std::move(loadedLevels[l].board));     //contains only the valid levels (the boards are moved, not copied)
+            levelsSpeeds.push_back(loadedLevels[l].delay);
+            levelsRules.push_back(loadedLevels[l].rule);
+            levelsPlanes.push_back(loadedLevels[l].plane);
         }
     }
     
-    if(!isValid){
-        levelsSpeeds.clear();
-        levelsSpeeds = validSpeeds;
+    if(loadedLevels.size() == 0){                           //if the file isn't correctly parsed
+        ofLogError() << "File levels.txt missing. Check in the data folder." << endl;
+    }
+    if(levels.size() == 0){                                 //if there isn't a valid level, create a 1*1 game's grid
+        levels.push_back(BitBoard(1, 1));                   //a dead cell
+        levelsSpeeds.push_back(LevelParser::defaultDelay);
+        levelsRules.push_back(LifeRule::conway());
+        levelsPlanes.push_back(false);
     }
-    levels = validLevels;
     
 }
 
 /*
 LEVELPARSER
- This method takes the txt-file's buffer, and returns a vector of matrixes (or a vector of game's grids).
+ This method takes the txt-file's buffer, and returns a vector of levels (a bit board, the delay and the rule for every level). The parsing is done by the LevelParser class, here the parser's errors are written in the log.
  
  The delay can't be < 60, if I set it < 60, it remains 60.
  If the delay is not a valid integer, the delay is set to the default (240).
  In both cases the game continues without interruptions.
  
- The matrix has the structure: [col[row, row,...], col[row, row,...], ...], so it can be called like this: "matrix[x][y]" rather than this: "matrix[y][x]"
+ The header can also set the level's rule in the B/S notation (births/survivals neighbours counts), for example: "##delay=240 rule=B36/S23".
+ Without a rule the level uses the Conway's rules (B3/S23). If the rule is not valid (or it is a B0 rule), the level uses the Conway's rules too.
+ The header can also set the board mode: "board=plane" makes the level the starting area of an unbounded plane (without the PACMAN effect).
+ 
+ The levels can be rectangular: the board's width is the length of the rows, and the height is the number of rows. So the cells are still called like this: "board.get(x, y)".
  
  */
-vector<vector<vector<Cell>>> Game::levelsParser(ofBuffer buffer){
-    vector<vector<vector<Cell>>> loadedLevels;
-    int cellSize = environment.getCellSize();
-    int y = 0;
+vector<LevelParser::Level> Game::levelsParser(const ofBuffer &buffer){
+    vector<LevelParser::Level> loadedLevels = LevelParser::parse(buffer.getData(), buffer.size());
     
-    for (auto line : buffer.getLines()){
-        
-        //parse spaces and the level's header
-        if(line[0] == '\0') continue;                                   // \0 => marks the end of the string
-        if(line[0] == '#' and line[1] == '#'){                          // line stars with ## (level's header)
-            unsigned int delay = 240;                                   //default delay
-            y = 0;
-            loadedLevels.push_back(vector<vector<Cell>>());             //add a void level's grid
-            
-            try{                                                        //try to convert the "delay" to int
-                vector<char> delayVec(line.begin() + 8, line.end());
-                string delayStr( delayVec.begin(), delayVec.end() );
-                delay = max(stoi(delayStr), 60);                        //we can't set the levels delay < 60
-            }
-            catch(...){                                                 // "..." catches everything.
-                ofLogError() << "Wrong sintax in a level declaration. This is an example of how should be the line before the level: ##delay=240" << endl;
-            }
-            levelsSpeeds.push_back(delay);                              //append the delay to the levelsSpeeds vector ( the loadedLevels[n] has a delay of levelsSpeeds[n] )
-            
-        }
-        //parse the level's matrix
-        if(line[0] == '0' || line[0] == '1'){
-            vector<string> row = ofSplitString(line, ",");                      //take the current line (row)
-            
-            for(int x=0; x<row.size(); x++){
-                Cell newCell = Cell(ofPoint(x * cellSize*2, y * cellSize*2, cellSize), cellSize);
-                
-                try{
-                    if(stoi(row[x]) == 1) newCell.giveBirth();
-                }
-                catch(...){
-                    ofLogError() << "No correct value in the level matrix: " <<  loadedLevels.size()-1 << endl;
-                }
-                
-                /*
-                when the parser processes the first row, it adds a row for every value in this row.
-                Then (when the y value is no longer 0) it assigns the new cell value to the respective row.
-                It allows to have this structure: [col[row, row,...]
-                */
-                if(y == 0){
-                    loadedLevels[loadedLevels.size()-1].push_back(vector<Cell>());  //for each col insert a row
-                }
-                loadedLevels[loadedLevels.size()-1][x].push_back(newCell);
-            }
-            y++;
-            
+    for(int l=0; l<loadedLevels.size(); l++){
+        for(const string &error : loadedLevels[l].errors){
+            ofLogError() << error << " (level index:  " << l << ")" << endl;
         }
     }
     return loadedLevels;
@@ -326,32 +348,11 @@ vector<vector<vector<Cell>>> Game::levelsParser(ofBuffer buffer){
 
 /*
  LEVELCHECKER
- This method takes a level's grid in input, and returns a message if it contains one of the handled errors,  otherwise it returns an empty string.
+ This method takes a level's board in input, and returns a message if it contains one of the handled errors,  otherwise it returns an empty string.
  
  */
-string Game::levelChecker(vector<vector<Cell>> level){
-    string message = "";
-    int aliveCells = 0;
-    
-    for(int x=0; x<level.size(); x++){  //n. columns
-        
-        //it checks if the level's matrix shape is a square
-        if( level[x].size() != level.size() ){                      // n. rows != n. columns ?
-            message =  "error in levels.txt. Levels must have a square shape (NxN).";
-        }
-        
-        //checks if there aren't alive cells within the level
-        for(int y=0; y<level[0].size(); y++){                       //n. rows
-            if(level[x][y].isAlive()) aliveCells++;
-        }
-    }
-    
-    if(aliveCells == 0){                                 //if there aren't alive cells, the level is not valid
-         message =  "The levels must have at least 1 alive cell.";
-    }
-    
-    return message;
-    
+string Game::levelChecker(const BitBoard &level){
+    return LevelParser::check(level);           //the checks don't depend on openFrameworks (the headless tools use them too)
 }
 
 /*
@@ -359,27 +360,43 @@ NEXTLEVEL
  
  This method is called when a level is finished. It:
     -increments the level index and selects the new grid's level
-    -gets the new size (used to move the camera) and the new delay
+    -gets the new size (used to move the camera), the new delay and the new rule
     -resets the angle (POV) and the time
     -setups the GUI and the new environment
-    -resets the soundtrack's matrix
+    -resets the soundtrack's board
 
 */
 void Game::nextLevel(){
     levelIndx++;
-    matrixSize = levels[levelIndx].size();
-    gameSize = (matrixSize + matrixSize-1) * environment.getCellSize();     //(boxes + spaces) * box's size
+    gameWidth = (2 * levels[levelIndx].getWidth() - 1) * environment.getCellSize();      //(boxes + spaces) * box's size
+    gameHeight = (2 * levels[levelIndx].getHeight() - 1) * environment.getCellSize();
     delay = levelsSpeeds[levelIndx];
     
     angle = 0;                                                              //reset the POV
     time = 1;                                                               //reset the timer (so the player starts before a fixed update's time)
     
-    environment.setup(levels[levelIndx]);                                   //SETUP THE NEW ENVIRONMENT
-    gui.setLevel(to_string(levelIndx));
-    if(musicOn) soundtrack.setMatrix(environment.getBoolLifeMatrix());      //reset the "music"
+    environment.setup(levels[levelIndx], levelsRules[levelIndx], levelsPlanes[levelIndx]);     //SETUP THE NEW ENVIRONMENT
+    ofLogNotice() << "Memory level " << levelIndx << " in the environment: " << environment.getMemorySize() << " bytes" << endl;
+    if(levelsRules[levelIndx] != LifeRule::conway()) gui.setLevel(to_string(levelIndx) + " (" + levelsRules[levelIndx].toString() + ")");
+    else gui.setLevel(to_string(levelIndx));
+    gui.setStats(environment.getGenerationStats(), environment.getStableGeneration(), environment.getCyclePeriod());
+    if(musicOn) soundtrack.setBoard(environment.getBoard());                //reset the "music"
+    updateHint();
     
 }
 
+/*
+ PREVIEWLEVEL
+ The level jumps ahead previewGenerations generations at every press (see Environment::skipGenerations()): the GUI shows the population and if the grid became stable.
+ It is a preview: when the game starts again the level is repeated from its beginning (see update()).
+*/
+void Game::previewLevel(){
+    environment.skipGenerations(previewGenerations);
+    previewGeneration += previewGenerations;
+    gui.setMessage("Preview: generation " + ofToString(previewGeneration) + " (f => skip " + ofToString(previewGenerations) + " more)");
+    gui.setStats(environment.getGenerationStats(), environment.getStableGeneration(), environment.getCyclePeriod());
+}
+
 /*
  REPEATLEVEL
  This method is similar to nextLevel() but the levelIndex is not incremented, and some variables remains the same.
@@ -389,19 +406,98 @@ void Game::repeatLevel(){
     angle = 0;                                                  //reset the POV
     time = 1;                                                   //reset the timer
     
-    environment.setup(levels[levelIndx]);
-    if(musicOn) soundtrack.setMatrix(environment.getBoolLifeMatrix());  //reset the "music"
+    environment.setup(levels[levelIndx], levelsRules[levelIndx], levelsPlanes[levelIndx]);
+    gui.setStats(environment.getGenerationStats(), environment.getStableGeneration(), environment.getCyclePeriod());
+    if(musicOn) soundtrack.setBoard(environment.getBoard());            //reset the "music"
+    updateHint();
+}
+
+/*
+ LOGMEMORYREPORT
+ It writes in the log file the memory used by every level: the old grid (one Cell object with its own box for every position) and the current bit board.
+ The grid's memory used by the environment (the two boards and the shared cell's flyweight) is written too.
+*/
+void Game::logMemoryReport(){
+    int cellSize = environment.getCellSize();
+    size_t cellMemorySize = Cell(ofPoint(0, 0, cellSize), cellSize).getMemorySize();
+    
+    for(int l=0; l<levels.size(); l++){
+        size_t numCells = size_t(levels[l].getWidth()) * levels[l].getHeight();
+        
+        ofLogNotice() << "Memory level " << l << " (" << levels[l].getWidth() << "x" << levels[l].getHeight() << "): "
+            << numCells * cellMemorySize << " bytes with Cell objects, "
+            << levels[l].getMemorySize() << " bytes with the bit board" << endl;
+    }
+}
+
+//the audio thread only writes the spikes in the monitor's ring: they are written in the log here, by the main thread
+void Game::logAudioSpikes(){
+    AudioMonitor::Spike spike;
+    while(audioMonitor.readSpike(spike)){
+        ofLogWarning() << "Audio callback " << spike.callback << " took " << ofToString(spike.duration / 1000, 2) << " ms ("
+            << ofToString(spike.load * 100, 0) << "% of the buffer) at " << ofToString(spike.time, 3) << " s" << endl;
+    }
+}
+
+void Game::logAudioReport(){
+    ofLogNotice() << "Audio " << AudioMonitor::toString(audioMonitor.getReport()) << endl;
+}
+
+/*
+ UPDATEHINT
+ The hint engine receives the grid after every generation (and after a new level, a repeated level or a rewind): the board is copied and the search restarts on the engine's thread, so this call doesn't wait for the search.
+ The plane levels have no hints: the rockets never reach a wall there (the hint of the previous level is cleared).
+*/
+void Game::updateHint(){
+    if(!hintOn) return;
+    if(levelsPlanes[levelIndx]){
+        hintEngine.clear();                                     //the previous level's hint isn't valid here
+        return;
+    }
+    hintEngine.setState(environment.getBoard(), levelsRules[levelIndx], delay, environment.getPlayerCell(), environment.getGenerationStats().generation);
+}
+
+/*
+ DRAWHINT
+ It draws the best hint found until now (it never waits for the search):
+    -the cell where the player must stand (green, orange if the player dies anyway in the next generation) and a line in the direction to face
+    -the new enemy cell (red) and the frames before the shot, if the best move is a shot
+ The fire frame is counted from the last generation (time is 1 after a generation).
+*/
+void Game::drawHint(){
+    HintEngine::Hint hint = hintEngine.getHint();
+    if(!hint.valid) return;
+    
+    int cellSize = environment.getCellSize();
+    float step = cellSize * 2;                                  //the world position is cell * cellSize * 2
+    ofPoint stand(hint.shooter.x * step, hint.shooter.y * step, cellSize);
+    
+    ofPushStyle();
+    ofNoFill();
+    ofSetColor(hint.safe ? ofColor(0, 255, 100) : ofColor(255, 140, 0));
+    ofDrawBox(stand, cellSize * 1.5);
+    ofDrawLine(stand, stand + ofPoint(hint.shooter.dirX, hint.shooter.dirY) * step);
+    if(hint.fire){
+        ofSetColor(ofColor(255, 0, 0));
+        ofDrawBox(ofPoint(hint.targetX * step, hint.targetY * step, cellSize), cellSize * 1.5);
+        ofDrawBitmapString(ofToString(max(0, hint.fireFrame - (time - 1))), stand + ofPoint(0, 0, step));
+    }
+    ofPopStyle();
 }
 
+//the camera must see the longest side of the grid
 int Game::getGameSize(){
-    return gameSize;
+    return max(gameWidth, gameHeight);
 }
 
 void Game::exit(ofEventArgs&){
+    logAudioReport();
     soundtrack.SoundtrackClose();                               //this avoids some errors closing the app
+    hintEngine.stop();
 }
 
 void Game::audioOut(float * output, int bufferSize, int nChannels){
+    AudioMonitor::Scope measure(audioMonitor, bufferSize);     //the whole callback, also when it is silent (paused)
     if(!pause && musicOn){
         soundtrack.play(output, bufferSize, nChannels);         //pass the audioOut parameters to the Soundtrack class
     }
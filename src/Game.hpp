@@ -2,7 +2,10 @@
 #include "ofMain.h"
 #include "Cell.hpp"
 #include "Environment.hpp"
+#include "LevelParser.hpp"
+#include "HintEngine.hpp"
 #include "Soundtrack.hpp"
+#include "AudioMonitor.hpp"
 #include "GUI.hpp"
 
 
@@ -13,19 +16,25 @@
  
  The methods are:
  
- -setup() => it initializes the game's parameters
+ -setup() => it initializes the game's parameters (the sample rate is the sound stream's one, for the audio monitor)
  -update() => it contains the game's logic
  -draw() => it draws the game (with the rotations) in a 3D world
  -drawGUI() => it draws the GUI if the game is paused (this is in a 2D world)
  -keyPressed() => it handles all the commands for the player + the pause button
+ -previewLevel() => (paused) it skips previewGenerations generations of the level and shows their stats in the GUI (the level restarts from the beginning when the game starts again)
  -nextLevel() => it allows to go to the next level
  -repeatLevel() => it allows to repeats the current level
  -loadLevels() => it loads levels from the levels.txt file in the bin/data folder
- -levelsParser() => it parses the txt levels file, and returns a vector of levels
+ -levelsParser() => it parses the txt levels file, and returns a vector of levels (bit boards, see LevelParser)
  -levelChecker() => it checks for some common errors in the levels file
- -getGameSize() => it returns the game's size (it considers the grid's size and the cell's size)
+ -logMemoryReport() => it writes in the log file the memory used by every level (old Cell's matrix vs bit board)
+ -getGameSize() => it returns the game's size (it considers the grid's longest side and the cell's size)
+ -logAudioSpikes() => it writes in the log the audio callbacks close to their deadline (see AudioMonitor)
+ -logAudioReport() => it writes in the log the audio monitor's report (the histogram of the callbacks' load, the overruns and the worst callback)
+ -updateHint() => it passes the new generation to the hint engine (if the hints are on)
+ -drawHint() => it draws the best hint found until now: where to stand (and the direction), the new enemy cell and the frames before the shot
  -exit() => it allows to close the audio stream
- -audioOut() => it allows to pass the audio data to the Soundtrack class
+ -audioOut() => it allows to pass the audio data to the Soundtrack class, every callback is measured by the audio monitor
 
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
@@ -35,18 +44,23 @@ class Game{
     private:
         Environment environment;
         Soundtrack soundtrack;
+        AudioMonitor audioMonitor;                  //the audio callbacks' load (written by the audio thread)
         GUI gui;
+        HintEngine hintEngine;                      //it searches the best shot on its own thread
         string logFileName;
     
-        vector<vector<vector<Cell>>> levels;        //vector of matrices (game's grids)
+        vector<BitBoard> levels;                    //vector of game's grids (1 bit for each cell)
         vector<int> levelsSpeeds;                   //speeds for each level
+        vector<LifeRule> levelsRules;               //rules for each level (B3/S23 if the header doesn't have a rule)
+        vector<bool> levelsPlanes;                  //board mode for each level (true => unbounded plane, false => torus)
         int levelIndx;                              //current level index
     
-        int matrixSize;                             //size of the current matrix (a matrix is matrixSize * matrixSize)
-        int gameSize;                               //size of the current matrix in the 3D world, (considering also the cellSize and the spaces)
+        int gameWidth;                              //size of the current matrix in the 3D world, (considering also the cellSize and the spaces)
+        int gameHeight;
     
         bool pause;
         bool musicOn;
+        bool hintOn;
     
         int delay;
         int time;                                   //allows more control respect to ofGetElapsedTimef(). set it to 1 at every level beginning
@@ -55,13 +69,24 @@ class Game{
         int angle;
         int prevAngle;
     
+        const int rewindGenerations = 10;           //generations restored by the rewind key
+        const double traceSeconds = 5;              //seconds written by the trace dump key
+        const long previewGenerations = 1024;       //generations skipped by the preview key (HashLife jumps, see Environment::skipGenerations())
+        long previewGeneration = 0;                 //the generation shown by the preview (0 => no preview)
+    
         void nextLevel();
         void repeatLevel();
-        vector<vector<vector<Cell>>> levelsParser(ofBuffer buffer);
-        string levelChecker(vector<vector<Cell>> level);
+        vector<LevelParser::Level> levelsParser(const ofBuffer &buffer);
+        string levelChecker(const BitBoard &level);
+        void logMemoryReport();
+        void previewLevel();
+        void logAudioSpikes();
+        void logAudioReport();
+        void updateHint();
+        void drawHint();
     
     public:
-        void setup();
+        void setup(int sampleRate = 44100);
         void update();
         void draw();
         void drawGUI();
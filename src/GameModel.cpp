@@ -0,0 +1,288 @@
+#include "GameModel.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+const int GameModel::rotationFrames;
+const int GameModel::directionsX[4] = {0, 1, 0, -1};
+const int GameModel::directionsY[4] = {1, 0, -1, 0};
+
+//the same initial state of Environment::setup(): the player in (width / 2, 1) facing down, the rocket hidden in the player's cell (its direction is set by its first update)
+void GameModel::setup(const BitBoard &level, const LifeRule &_rule, int _delay){
+    board = level;
+    nextBoard.resize(level.getWidth(), level.getHeight());
+    rule = _rule;
+    delay = _delay;
+    time = 1;
+    frameCount = 0;
+    rotation = 0;
+    player = Actor();
+    player.x = level.getWidth() / 2;
+    player.y = 1;
+    player.dirY = 1;
+    rocket = Actor();
+    rocket.x = player.x;
+    rocket.y = player.y;
+    rocketParent = Actor();
+    rocketFlying = false;
+    playerAlive = true;
+    won = false;
+}
+
+/*
+ PRESS
+
+ Like Game::keyPressed(): the keys are ignored while a rotation is animated. The player moves (or turns and moves) immediately, the rocket is only fired: it moves in the next frame.
+*/
+bool GameModel::press(Key key){
+    if(!canPress()) return false;
+
+    if(key == SPACE){
+        rocketFlying = true;                                //Rocket::controls(): it is ignored if the rocket is already flying
+        return true;
+    }
+
+    int dirX = player.dirX;
+    int dirY = player.dirY;
+    if(key == LEFT){                                        //90° counterclockwise rotation
+        player.dirX = -dirY;
+        player.dirY = dirX;
+        rotation = rotationFrames;
+    }
+    else if(key == RIGHT){                                  //270° counterclockwise rotation
+        player.dirX = dirY;
+        player.dirY = -dirX;
+        rotation = rotationFrames;
+    }
+    player.x += player.dirX;
+    player.y += player.dirY;
+    return true;
+}
+
+/*
+ FRAME
+
+ Like Game::update(): every delay frames the win is checked and the grid advances, in the other frames only the player and the rocket move (and the rotation goes on).
+*/
+void GameModel::frame(){
+    if(getStatus() != PLAYING) return;
+    frameCount++;
+
+    if(time % delay == 0){
+        time = 0;
+        if(board.countAlive() == 0) won = true;
+        else updateActors(true);
+    }
+    else{
+        updateActors(false);
+        if(rotation > 0) rotation--;
+    }
+    time++;
+}
+
+//the same steps of Environment::update()
+void GameModel::updateActors(bool updateMatrix){
+    Actor prevRocket = rocket;
+
+    if(updateMatrix){
+        board.nextGeneration(nextBoard, rule);
+        std::swap(board, nextBoard);
+    }
+
+    if(isOutside(player.x, player.y)){                      //the player goes back in the rocket's cell
+        player.x = prevRocket.x;
+        player.y = prevRocket.y;
+    }
+    if(!isOutside(player.x, player.y) && board.get(player.x, player.y)) playerAlive = false;
+
+    if(rocketFlying){
+        rocket.x += rocket.dirX;
+        rocket.y += rocket.dirY;
+    }
+    else{
+        rocket.dirX = player.dirX;
+        rocket.dirY = player.dirY;
+        rocketParent = player;
+        rocket.x = player.x;
+        rocket.y = player.y;
+    }
+
+    Actor newRocket = rocket;
+    if(rocketFlying && isOutside(newRocket.x, newRocket.y)){
+        board.set(prevRocket.x, prevRocket.y, true);
+        rocketFlying = false;
+        rocket.x = rocketParent.x;
+        rocket.y = rocketParent.y;
+    }
+
+    bool horizontal = std::abs(newRocket.dirX) == 1;
+    if(rocketFlying && board.countNeighbours(newRocket.x, newRocket.y, horizontal, !horizontal) > 0){
+        board.set(newRocket.x, newRocket.y, true);
+        rocketFlying = false;
+        rocket.x = rocketParent.x;
+        rocket.y = rocketParent.y;
+    }
+}
+
+bool GameModel::isOutside(int x, int y) const{
+    return x < 0 || y < 0 || x >= board.getWidth() || y >= board.getHeight();
+}
+
+bool GameModel::canPress() const{
+    return rotation == 0 && getStatus() == PLAYING;
+}
+
+GameModel::Status GameModel::getStatus() const{
+    if(won) return WON;
+    if(!playerAlive) return DEAD;
+    return PLAYING;
+}
+
+const BitBoard &GameModel::getBoard() const{
+    return board;
+}
+
+const GameModel::Actor &GameModel::getPlayer() const{
+    return player;
+}
+
+const GameModel::Actor &GameModel::getRocket() const{
+    return rocket;
+}
+
+bool GameModel::isRocketFlying() const{
+    return rocketFlying;
+}
+
+long GameModel::getFrame() const{
+    return frameCount;
+}
+
+int GameModel::getTime() const{
+    return time;
+}
+
+/*
+ FLIGHT
+
+ The rocket is fired from the cell (x, y): it moves one cell for every frame, on a grid that doesn't change during the flight (the flight ends before the next generation).
+ A rocket without a direction never becomes a cell: frames is 0.
+*/
+GameModel::Flight GameModel::flight(const BitBoard &board, int x, int y, int dirX, int dirY){
+    if(dirX == 0 && dirY == 0) return {x, y, 0};
+    bool horizontal = std::abs(dirX) == 1;
+
+    for(int frames=1; ; frames++){
+        int prevX = x;
+        int prevY = y;
+        x += dirX;
+        y += dirY;
+        if(x < 0 || y < 0 || x >= board.getWidth() || y >= board.getHeight()) return {prevX, prevY, frames};
+        if(board.countNeighbours(x, y, horizontal, !horizontal) > 0) return {x, y, frames};
+    }
+}
+
+/*
+ FINDTARGETS
+
+ The player starts from its cell at the frame "frame" (the frames are counted from the last generation), the keys must end before lastFrame (the last frame before the next generation):
+    -the moves are the shortest path (in frames) to the firing cell and direction, through the dead cells (see findPaths())
+    -the rocket is fired when the next key can be pressed, and it must land before lastFrame (the grid doesn't change during the flight)
+ Only the fastest way to create every new cell is returned (sorted by cell). The cells that are already alive or that would hit the player are not targets.
+*/
+void GameModel::findTargets(const BitBoard &board, const Actor &player, int frame, int lastFrame, std::vector<Target> &targets){
+    targets.clear();
+    std::vector<Path> paths;
+    findPaths(board, player, frame, lastFrame, paths);
+
+    int width = board.getWidth();
+    int cells = width * board.getHeight();
+    std::vector<int> bestPath(cells, -1);
+    std::vector<int> bestFrame(cells, lastFrame + 1);
+    for(int p=0; p<int(paths.size()); p++){
+        if(paths[p].frames > lastFrame) continue;
+        int x = (p / 4) % width;
+        int y = (p / 4) / width;
+        Flight rocket = flight(board, x, y, directionsX[p % 4], directionsY[p % 4]);
+        int end = paths[p].frames + rocket.frames;
+        if(rocket.frames == 0 || end > lastFrame) continue;
+        if(board.get(rocket.x, rocket.y) || (rocket.x == x && rocket.y == y)) continue;   //nothing changes, or the player is hit
+
+        int cell = rocket.y * width + rocket.x;
+        if(end < bestFrame[cell]){
+            bestFrame[cell] = end;
+            bestPath[cell] = p;
+        }
+    }
+
+    for(int cell=0; cell<cells; cell++){
+        int p = bestPath[cell];
+        if(p < 0) continue;
+
+        Target target;
+        target.x = cell % width;
+        target.y = cell / width;
+        target.shooter.x = (p / 4) % width;
+        target.shooter.y = (p / 4) / width;
+        target.shooter.dirX = directionsX[p % 4];
+        target.shooter.dirY = directionsY[p % 4];
+        target.fireFrame = paths[p].frames;
+        target.endFrame = bestFrame[cell];
+        for(int step=p; paths[step].prev >= 0; step=paths[step].prev) target.moves.push_back(paths[step].key);
+        std::reverse(target.moves.begin(), target.moves.end());
+        targets.push_back(std::move(target));
+    }
+}
+
+/*
+ FINDPATHS
+
+ Dijkstra on the states (cell, direction): paths[(y * width + x) * 4 + direction].frames is the first frame when a key can be pressed in that state (lastFrame + 1 if it can't be reached before lastFrame).
+ UP moves one cell forward (the next key in the next frame), LEFT and RIGHT turn and move one cell (the next key after the rotation). The player can't leave the grid or enter an alive cell.
+*/
+void GameModel::findPaths(const BitBoard &board, const Actor &player, int frame, int lastFrame, std::vector<Path> &paths){
+    int width = board.getWidth();
+    int height = board.getHeight();
+    paths.assign(size_t(width) * height * 4, {lastFrame + 1, -1, UP});
+
+    //the costs are 1 and rotationFrames: a circular queue of buckets (one for every frame) instead of a heap
+    const int bucketCount = rotationFrames + 1;
+    std::vector<std::vector<int>> buckets(bucketCount);
+    int direction = 0;
+    while(direction < 3 && (directionsX[direction] != player.dirX || directionsY[direction] != player.dirY)) direction++;
+    int start = (player.y * width + player.x) * 4 + direction;
+    paths[start].frames = frame;
+    buckets[frame % bucketCount].push_back(start);
+    int queued = 1;
+
+    for(int current=frame; queued > 0 && current < lastFrame; current++){
+        std::vector<int> &bucket = buckets[current % bucketCount];
+        for(size_t b=0; b<bucket.size(); b++){
+            int state = bucket[b];
+            if(paths[state].frames != current) continue;           //already reached with fewer frames
+
+            int x = (state / 4) % width;
+            int y = (state / 4) / width;
+            int d = state % 4;
+            const Key keys[3] = {UP, LEFT, RIGHT};
+            const int directions[3] = {d, (d + 3) % 4, (d + 1) % 4};      //LEFT: (dirX, dirY) => (-dirY, dirX)
+            const int costs[3] = {1, rotationFrames, rotationFrames};
+
+            for(int k=0; k<3; k++){
+                int nextX = x + directionsX[directions[k]];
+                int nextY = y + directionsY[directions[k]];
+                if(nextX < 0 || nextY < 0 || nextX >= width || nextY >= height || board.get(nextX, nextY)) continue;
+
+                int next = (nextY * width + nextX) * 4 + directions[k];
+                int frames = current + costs[k];
+                if(frames < paths[next].frames){
+                    paths[next] = {frames, state, keys[k]};
+                    buckets[frames % bucketCount].push_back(next);
+                    queued++;
+                }
+            }
+        }
+        queued -= int(bucket.size());
+        bucket.clear();
+    }
+}
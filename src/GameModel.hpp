@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include "BitBoard.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ GAMEMODEL
+ The GameModel class is the game without the window: the same rules of Game::update(), Environment::update(), Player and Rocket, frame by frame, on the grid's cells instead of the world's positions (a world position is cell * cellSize * 2).
+ The solver and the hint engine simulate thousands of games with it (see LevelSolver).
+
+ A frame is one call of Game::update() on a torus level (the PACMAN effect):
+    -every delay frames (time % delay == 0) the level is won if there aren't alive cells, otherwise the grid advances one generation
+    -the player goes back to the rocket's position if it is outside the grid, and it dies if it is on an alive cell
+    -the rocket follows the player, or it flies one cell for every frame if it was fired
+    -the rocket becomes an enemy cell when it reaches a wall (in its previous cell) or when it has an alive neighbour on its axis (in its cell)
+    -the player's rotations (left/right) last rotationFrames frames (the camera's animation), and the keys are ignored until they end
+
+ The methods are:
+
+ -setup() => it starts a level (the player in the middle of the second row, facing down)
+ -press() => it handles a key, like Game::keyPressed() (it returns false if the key is ignored)
+ -frame() => it advances one frame, like Game::update()
+ -canPress() => it returns true if the keys are not ignored (the rotation ended)
+ -getStatus() => it returns if the game is playing, won or lost
+ -getBoard() => it returns the grid
+ -getPlayer() => it returns the player's cell and direction
+ -getRocket() => it returns the rocket's cell and direction
+ -isRocketFlying() => it returns true if the rocket has been fired and it hasn't hit anything yet
+ -getFrame() => it returns the frames since setup()
+ -getTime() => it returns the Game's time (the next generation is at the frame with time % delay == 0)
+ -flight() => (static) it returns where a rocket fired from a cell becomes an enemy cell, without simulating the frames
+ -findTargets() => (static) it returns every enemy cell that the player can create before the next generation, with the fastest keys to create it (the solver's and the hint engine's moves)
+ -updateActors() => (private) it is Environment::update(): the generation (if updateMatrix is true), then the player and the rocket
+ -isOutside() => (private) it returns true if the cell is outside the grid (Environment::wallsCollision())
+ -findPaths() => (private, static) it finds the fewest frames to reach every cell and direction (Dijkstra), and the keys of the paths
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class GameModel{
+
+    public:
+        enum Key{UP, LEFT, RIGHT, SPACE};
+        enum Status{PLAYING, WON, DEAD};
+
+        struct Actor{
+            int x = 0;
+            int y = 0;
+            int dirX = 0;
+            int dirY = 0;
+        };
+
+        struct Flight{
+            int x;                              //the new enemy cell
+            int y;
+            int frames;                         //the frames of the flight (the cell is born in the last one)
+        };
+
+        struct Target{                          //a new enemy cell that a rocket can create before the next generation
+            int x;
+            int y;
+            Actor shooter;                      //where the player fires (cell and direction)
+            int fireFrame;                      //the frame of the SPACE key
+            int endFrame;                       //the frame when the next key can be pressed (the rocket has landed)
+            std::vector<Key> moves;             //the keys from the player's cell to the shooter's cell
+        };
+
+        static const int rotationFrames = 17;   //the camera turns 90° at 5° per frame: the key's frame and 17 more
+
+        void setup(const BitBoard &level, const LifeRule &_rule = LifeRule::conway(), int _delay = 240);
+        bool press(Key key);
+        void frame();
+        bool canPress() const;
+        Status getStatus() const;
+        const BitBoard &getBoard() const;
+        const Actor &getPlayer() const;
+        const Actor &getRocket() const;
+        bool isRocketFlying() const;
+        long getFrame() const;
+        int getTime() const;
+        static Flight flight(const BitBoard &board, int x, int y, int dirX, int dirY);
+        static void findTargets(const BitBoard &board, const Actor &player, int frame, int lastFrame, std::vector<Target> &targets);
+
+    private:
+        struct Path{
+            int frames;                         //the frame when the next key can be pressed
+            int prev;                           //the previous cell and direction (-1 => start)
+            Key key;                            //the key from prev to here
+        };
+
+        static const int directionsX[4];        //down, right, up, left (the direction's index of the paths)
+        static const int directionsY[4];
+
+        BitBoard board;
+        BitBoard nextBoard;
+        LifeRule rule;
+        int delay = 240;
+        int time = 1;                           //like Game::time: 1 at the beginning, so the level doesn't update immediately
+        long frameCount = 0;
+        int rotation = 0;                       //frames left of the current rotation
+        Actor player;
+        Actor rocket;
+        Actor rocketParent;                     //the player's cell when the rocket was fired (the rocket goes back there)
+        bool rocketFlying = false;
+        bool playerAlive = true;
+        bool won = false;
+
+        void updateActors(bool updateMatrix);
+        bool isOutside(int x, int y) const;
+        static void findPaths(const BitBoard &board, const Actor &player, int frame, int lastFrame, std::vector<Path> &paths);
+
+};
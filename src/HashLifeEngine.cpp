@@ -0,0 +1,455 @@
+#include "HashLifeEngine.hpp"
+#include <algorithm>
+#include <cstdint>
+
+const uint32_t HashLifeEngine::noNode;
+
+/*
+ HASHLIFEENGINE contructor
+
+ maxNodes is the bound of the nodes' memory (about 40 bytes + the hash table's entry for every node).
+*/
+HashLifeEngine::HashLifeEngine(size_t _maxNodes){
+    maxNodes = _maxNodes;
+    jumpLimit = SIZE_MAX;
+    width = 0;
+    height = 0;
+    torus = false;
+    planeMode = false;
+    generation = 0;
+    root = newLeaves();
+}
+
+//it deletes all the nodes and creates the 2 cells (dead == 0 and alive == 1)
+uint32_t HashLifeEngine::newLeaves(){
+    nodes.clear();
+    nodeTable.clear();
+    emptyNodes.clear();
+
+    Node dead = {noNode, noNode, noNode, noNode, noNode, 0, -1, 0};
+    Node alive = {noNode, noNode, noNode, noNode, noNode, 0, -1, 1};
+    nodes.push_back(dead);
+    nodes.push_back(alive);
+    return 0;
+}
+
+/*
+ LOAD
+
+ If the level is a power of 2 square (and the plane mode is off), the root is the level itself (torus mode). Otherwise the root is a square centered in (0, 0) that contains the level (plane mode).
+*/
+void HashLifeEngine::load(const BitBoard &level){
+    load(level, level.getWidth(), level.getHeight());
+}
+
+//the cells of the area outside the level are dead (build() returns empty nodes there)
+void HashLifeEngine::load(const BitBoard &level, int _width, int _height){
+    width = std::max(_width, level.getWidth());
+    height = std::max(_height, level.getHeight());
+    torus = !planeMode && width == height && width >= 2 && (width & (width - 1)) == 0;
+    generation = 0;
+    newLeaves();
+
+    int rootLevel = 1;
+    if(torus){
+        while((1 << rootLevel) < width) rootLevel++;
+        root = build(level, rootLevel, 0, 0);
+    }
+    else{
+        while((1 << (rootLevel - 1)) < std::max(width, height)) rootLevel++;
+        int offset = 1 << (rootLevel - 1);
+        root = build(level, rootLevel, -offset, -offset);
+    }
+}
+
+//it is used by the next load()
+void HashLifeEngine::setPlaneMode(bool _planeMode){
+    planeMode = _planeMode;
+}
+
+//the cached results were computed with the old rule
+void HashLifeEngine::setRule(const LifeRule &_rule){
+    if(_rule == rule) return;
+    rule = _rule;
+    for(Node &node : nodes){
+        node.result = noNode;
+        node.resultStep = -1;
+    }
+}
+
+//it builds the node of the square [fromX, fromX + 2^nodeLevel) * [fromY, fromY + 2^nodeLevel) of the level. The empty parts become a single empty node.
+uint32_t HashLifeEngine::build(const BitBoard &level, int nodeLevel, int fromX, int fromY){
+    int size = 1 << nodeLevel;
+    if(fromX >= level.getWidth() || fromY >= level.getHeight() || fromX + size <= 0 || fromY + size <= 0){
+        return emptyNode(nodeLevel);
+    }
+    if(nodeLevel == 0) return level.get(fromX, fromY) ? 1 : 0;
+    if(nodeLevel >= 4 && level.isRegionEmpty(fromX, fromY, fromX + size, fromY + size)) return emptyNode(nodeLevel);
+
+    int half = size / 2;
+    uint32_t nw = build(level, nodeLevel - 1, fromX, fromY);
+    uint32_t ne = build(level, nodeLevel - 1, fromX + half, fromY);
+    uint32_t sw = build(level, nodeLevel - 1, fromX, fromY + half);
+    uint32_t se = build(level, nodeLevel - 1, fromX + half, fromY + half);
+    return join(nw, ne, sw, se);
+}
+
+/*
+ JOIN
+
+ It returns the node made of the 4 passed nodes. If this node already exists, it is not created again (nodes are canonical, this is why HashLife works).
+*/
+uint32_t HashLifeEngine::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se){
+    NodeKey key = {nw, ne, sw, se};
+    auto found = nodeTable.find(key);
+    if(found != nodeTable.end()) return found->second;
+
+    Node node;
+    node.nw = nw;
+    node.ne = ne;
+    node.sw = sw;
+    node.se = se;
+    node.result = noNode;
+    node.level = nodes[nw].level + 1;
+    node.resultStep = -1;
+    node.population = 0;
+    for(uint32_t child : {nw, ne, sw, se}){
+        uint64_t population = nodes[child].population;
+        node.population = population > UINT64_MAX - node.population ? UINT64_MAX : node.population + population;     //saturated: the torus' tilings of the big jumps can have more than 2^64 cells
+    }
+
+    uint32_t index = nodes.size();
+    nodes.push_back(node);
+    nodeTable[key] = index;
+    return index;
+}
+
+uint32_t HashLifeEngine::emptyNode(int level){
+    if(int(emptyNodes.size()) <= level) emptyNodes.resize(level + 1, noNode);
+    if(emptyNodes[level] == noNode){
+        if(level == 0) emptyNodes[level] = 0;
+        else{
+            uint32_t child = emptyNode(level - 1);
+            emptyNodes[level] = join(child, child, child, child);
+        }
+    }
+    return emptyNodes[level];
+}
+
+//it returns a node of level + 1 with the passed node in its center (the center doesn't move)
+uint32_t HashLifeEngine::expand(uint32_t node){
+    Node n = nodes[node];
+    uint32_t empty = emptyNode(n.level - 1);
+
+    return join(join(empty, empty, empty, n.nw), join(empty, empty, n.ne, empty),
+                join(empty, n.sw, empty, empty), join(n.se, empty, empty, empty));
+}
+
+//it returns the central square (level - 1) of the node, without advancing the time
+uint32_t HashLifeEngine::centre(uint32_t node){
+    Node n = nodes[node];
+    return join(nodes[n.nw].se, nodes[n.ne].sw, nodes[n.sw].ne, nodes[n.se].nw);
+}
+
+/*
+ SUCCESSOR
+
+ It returns the central square (level k-1) of a node (level k) after 2^j generations (j <= k-2).
+ The node is split in 9 overlapping squares of level k-1, which are advanced recursively (2^(k-3) generations at most). Then:
+    -if j == k-2 (full speed), they are combined in 4 squares which are advanced again
+    -if j < k-2, they are already advanced 2^j generations, and their centers are combined.
+ The result is cached in the node, so the next time it costs nothing.
+ If there are more than jumpLimit nodes, it returns noNode without caching anything, and so do all its callers: the jump is aborted.
+*/
+uint32_t HashLifeEngine::successor(uint32_t node, int j){
+    if(nodes[node].result != noNode && nodes[node].resultStep == j) return nodes[node].result;
+    if(nodes.size() > jumpLimit) return noNode;                 //the jump is aborted (see boundedJump())
+
+    int k = nodes[node].level;
+    uint32_t result;
+
+    if(nodes[node].population == 0){
+        result = emptyNode(k - 1);
+    }
+    else if(k == 2){
+        result = life4x4(node);
+    }
+    else{
+        int subStep = std::min(j, k - 3);
+        Node n = nodes[node];
+        Node a = nodes[n.nw], b = nodes[n.ne], c = nodes[n.sw], d = nodes[n.se];
+
+        uint32_t c1 = successor(n.nw, subStep);
+        uint32_t c2 = successor(join(a.ne, b.nw, a.se, b.sw), subStep);
+        uint32_t c3 = successor(n.ne, subStep);
+        uint32_t c4 = successor(join(a.sw, a.se, c.nw, c.ne), subStep);
+        uint32_t c5 = successor(join(a.se, b.sw, c.ne, d.nw), subStep);
+        uint32_t c6 = successor(join(b.sw, b.se, d.nw, d.ne), subStep);
+        uint32_t c7 = successor(n.sw, subStep);
+        uint32_t c8 = successor(join(c.ne, d.nw, c.se, d.sw), subStep);
+        uint32_t c9 = successor(n.se, subStep);
+        for(uint32_t square : {c1, c2, c3, c4, c5, c6, c7, c8, c9}){
+            if(square == noNode) return noNode;
+        }
+
+        if(j < k - 2){
+            result = join(join(nodes[c1].se, nodes[c2].sw, nodes[c4].ne, nodes[c5].nw),
+                          join(nodes[c2].se, nodes[c3].sw, nodes[c5].ne, nodes[c6].nw),
+                          join(nodes[c4].se, nodes[c5].sw, nodes[c7].ne, nodes[c8].nw),
+                          join(nodes[c5].se, nodes[c6].sw, nodes[c8].ne, nodes[c9].nw));
+        }
+        else{
+            uint32_t nw = successor(join(c1, c2, c4, c5), subStep);
+            uint32_t ne = successor(join(c2, c3, c5, c6), subStep);
+            uint32_t sw = successor(join(c4, c5, c7, c8), subStep);
+            uint32_t se = successor(join(c5, c6, c8, c9), subStep);
+            if(nw == noNode || ne == noNode || sw == noNode || se == noNode) return noNode;
+            result = join(nw, ne, sw, se);
+        }
+    }
+
+    nodes[node].result = result;
+    nodes[node].resultStep = j;
+    return result;
+}
+
+//the base case: the central 2x2 cells of a 4x4 node after 1 generation (with the engine's rule)
+uint32_t HashLifeEngine::life4x4(uint32_t node){
+    bool cells[4][4];
+    for(int y=0; y<4; y++){
+        for(int x=0; x<4; x++){
+            cells[x][y] = getCell(node, x, y);
+        }
+    }
+
+    uint32_t next[4];
+    for(int i=0; i<4; i++){
+        int x = 1 + i % 2;
+        int y = 1 + i / 2;
+        int count = 0;
+
+        for(int dx=-1; dx<=1; dx++){
+            for(int dy=-1; dy<=1; dy++){
+                if((dx != 0 || dy != 0) && cells[x + dx][y + dy]) count++;
+            }
+        }
+        next[i] = (cells[x][y] ? rule.isSurvival(count) : rule.isBirth(count)) ? 1 : 0;
+    }
+    return join(next[0], next[1], next[2], next[3]);
+}
+
+/*
+ JUMP
+
+ It advances 2^j generations.
+ -torus: the root is repeated (like the PACMAN effect does) until the tiled node has level j+2, then a single successor() advances it 2^j generations.
+    -if j < rootLevel, the tiled node is join(root, root, root, root) and the result is the whole torus shifted of half its size. Repeating the result 4 times and taking its center removes the shift.
+    -otherwise the result is a tiling of the torus too, and its corner is the torus' origin (2^j is a multiple of the torus' size): the torus is its nw node of rootLevel.
+    The tiled nodes are canonical, so the 9 squares of every level of the tiling are the same node: a jump costs O(j), not O(2^j / size).
+ -plane: the root is expanded until the pattern is far from the borders (the result can't be wrong), then its successor becomes the new root (the center is always the same).
+ It returns false if the jump has been aborted by jumpLimit: the board and the generation don't change.
+*/
+bool HashLifeEngine::jump(int j){
+    int rootLevel = nodes[root].level;
+
+    if(torus){
+        uint32_t tiled = join(root, root, root, root);
+        while(nodes[tiled].level < j + 2) tiled = join(tiled, tiled, tiled, tiled);
+        uint32_t shifted = successor(tiled, j);
+        if(shifted == noNode) return false;
+
+        if(j < rootLevel) root = centre(join(shifted, shifted, shifted, shifted));
+        else{
+            while(nodes[shifted].level > rootLevel) shifted = nodes[shifted].nw;
+            root = shifted;
+        }
+    }
+    else{
+        while(true){
+            Node n = nodes[root];
+            if(n.level >= j + 2){
+                uint64_t innerPopulation = nodes[nodes[n.nw].se].population + nodes[nodes[n.ne].sw].population +
+                                           nodes[nodes[n.sw].ne].population + nodes[nodes[n.se].nw].population;
+                if(innerPopulation == n.population) break;
+            }
+            root = expand(root);
+        }
+        uint32_t next = successor(expand(root), j);
+        if(next == noNode) return false;
+        root = next;
+    }
+    generation += 1L << j;
+    return true;
+}
+
+void HashLifeEngine::step(){
+    advance(1);
+}
+
+//a jump for every bit of generations
+void HashLifeEngine::advance(long generations){
+    for(int j=0; generations > 0; j++, generations >>= 1){
+        if(generations & 1) boundedJump(j);
+    }
+}
+
+/*
+ BOUNDEDJUMP
+
+ It advances 2^j generations without more than maxNodes nodes: the jump is aborted when the nodes reach maxNodes, then the garbage is collected and the jump is split in 2 jumps of 2^(j-1) generations (each one bounded in the same way).
+ A single generation is never split: if the board alone needs more than maxNodes nodes, the bound is exceeded by that generation only.
+*/
+void HashLifeEngine::boundedJump(int j){
+    if(nodes.size() > maxNodes) collectGarbage();
+
+    jumpLimit = j > 0 ? maxNodes : SIZE_MAX;
+    bool done = jump(j);
+    jumpLimit = SIZE_MAX;
+    if(done) return;
+
+    collectGarbage();                                           //the aborted jump's nodes are unreachable
+    boundedJump(j - 1);
+    boundedJump(j - 1);
+}
+
+//in plane mode, the root is centered in (0, 0): the offset maps the level's coordinates to the root's coordinates
+int64_t HashLifeEngine::getRootOffset() const{
+    return torus ? 0 : int64_t(1) << (nodes[root].level - 1);
+}
+
+bool HashLifeEngine::get(int x, int y) const{
+    int64_t rootX = x + getRootOffset();
+    int64_t rootY = y + getRootOffset();
+    int64_t size = int64_t(1) << nodes[root].level;
+
+    if(rootX < 0 || rootY < 0 || rootX >= size || rootY >= size) return false;
+    return getCell(root, rootX, rootY);
+}
+
+//in plane mode, the root is expanded until it contains the cell
+void HashLifeEngine::set(int x, int y, bool alive){
+    while(true){
+        int64_t rootX = x + getRootOffset();
+        int64_t rootY = y + getRootOffset();
+        int64_t size = int64_t(1) << nodes[root].level;
+
+        if(rootX >= 0 && rootY >= 0 && rootX < size && rootY < size){
+            root = setCell(root, rootX, rootY, alive);
+            return;
+        }
+        root = expand(root);
+    }
+}
+
+bool HashLifeEngine::getCell(uint32_t node, int64_t x, int64_t y) const{
+    while(nodes[node].level > 0){
+        if(nodes[node].population == 0) return false;
+
+        int64_t half = int64_t(1) << (nodes[node].level - 1);
+        bool east = x >= half;
+        bool south = y >= half;
+        if(east) x -= half;
+        if(south) y -= half;
+        node = south ? (east ? nodes[node].se : nodes[node].sw) : (east ? nodes[node].ne : nodes[node].nw);
+    }
+    return node == 1;
+}
+
+//nodes can't be modified (they are shared), so the path from the root to the cell is rebuilt
+uint32_t HashLifeEngine::setCell(uint32_t node, int64_t x, int64_t y, bool alive){
+    if(nodes[node].level == 0) return alive ? 1 : 0;
+
+    Node n = nodes[node];
+    int64_t half = int64_t(1) << (n.level - 1);
+    if(y < half){
+        if(x < half) return join(setCell(n.nw, x, y, alive), n.ne, n.sw, n.se);
+        return join(n.nw, setCell(n.ne, x - half, y, alive), n.sw, n.se);
+    }
+    if(x < half) return join(n.nw, n.ne, setCell(n.sw, x, y - half, alive), n.se);
+    return join(n.nw, n.ne, n.sw, setCell(n.se, x - half, y - half, alive));
+}
+
+long HashLifeEngine::countAlive() const{
+    return nodes[root].population;
+}
+
+//only the level's area [0, width) * [0, height) is copied
+void HashLifeEngine::copyTo(BitBoard &board) const{
+    if(board.getWidth() != width || board.getHeight() != height) board.resize(width, height);
+    else board.clear();
+
+    copyCells(root, -getRootOffset(), -getRootOffset(), board);
+}
+
+void HashLifeEngine::copyCells(uint32_t node, int64_t fromX, int64_t fromY, BitBoard &board) const{
+    const Node &n = nodes[node];
+    if(n.population == 0) return;
+
+    int64_t size = int64_t(1) << n.level;
+    if(fromX >= board.getWidth() || fromY >= board.getHeight() || fromX + size <= 0 || fromY + size <= 0) return;
+
+    if(n.level == 0){
+        board.set(fromX, fromY, true);
+        return;
+    }
+    int64_t half = size / 2;
+    copyCells(n.nw, fromX, fromY, board);
+    copyCells(n.ne, fromX + half, fromY, board);
+    copyCells(n.sw, fromX, fromY + half, board);
+    copyCells(n.se, fromX + half, fromY + half, board);
+}
+
+bool HashLifeEngine::isTorus() const{
+    return torus;
+}
+
+long HashLifeEngine::getGeneration() const{
+    return generation;
+}
+
+size_t HashLifeEngine::getNodeCount() const{
+    return nodes.size();
+}
+
+size_t HashLifeEngine::getMemorySize() const{
+    size_t tableEntry = sizeof(NodeKey) + sizeof(uint32_t) + 2 * sizeof(void *);
+    return nodes.capacity() * sizeof(Node) + nodeTable.size() * tableEntry + nodeTable.bucket_count() * sizeof(void *);
+}
+
+/*
+ COLLECTGARBAGE
+
+ Only the nodes used by the root are kept (the cached results are deleted), then the hash table is rebuilt.
+*/
+void HashLifeEngine::collectGarbage(){
+    std::vector<Node> newNodes(nodes.begin(), nodes.begin() + 2);
+    std::vector<uint32_t> newIndexes(nodes.size(), noNode);
+    newIndexes[0] = 0;
+    newIndexes[1] = 1;
+
+    root = copyNode(root, newNodes, newIndexes);
+
+    nodes.swap(newNodes);
+    nodeTable.clear();
+    emptyNodes.clear();
+    for(uint32_t i=2; i<nodes.size(); i++){
+        NodeKey key = {nodes[i].nw, nodes[i].ne, nodes[i].sw, nodes[i].se};
+        nodeTable[key] = i;
+    }
+}
+
+uint32_t HashLifeEngine::copyNode(uint32_t node, std::vector<Node> &newNodes, std::vector<uint32_t> &newIndexes) const{
+    if(newIndexes[node] != noNode) return newIndexes[node];
+
+    Node n = nodes[node];
+    n.nw = copyNode(n.nw, newNodes, newIndexes);
+    n.ne = copyNode(n.ne, newNodes, newIndexes);
+    n.sw = copyNode(n.sw, newNodes, newIndexes);
+    n.se = copyNode(n.se, newNodes, newIndexes);
+    n.result = noNode;
+    n.resultStep = -1;
+
+    newIndexes[node] = newNodes.size();
+    newNodes.push_back(n);
+    return newIndexes[node];
+}
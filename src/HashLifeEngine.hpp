@@ -0,0 +1,122 @@
+#pragma once
+#include <unordered_map>
+#include "LifeBackend.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ HASHLIFEENGINE
+ The HashLifeEngine class is a LifeBackend based on the HashLife algorithm (quadtree memoization).
+ The board is a quadtree: a node of level k is a 2^k * 2^k square made of 4 nodes of level k-1 (nw, ne, sw, se), and a node of level 0 is a cell.
+ Equal squares are stored only once (nodes are canonical, see join()), and every node remembers its "result": its central 2^(k-1) square after 2^j generations.
+ So repeated patterns are computed only once, and big jumps (2^k generations in one step) cost like a few generations.
+
+ There are 2 modes:
+    -torus => if the level is a square with a power of 2 size (8x8, 64x64, 4096x4096...), the PACMAN effect is exact, like in the game.
+    -plane => otherwise, the board is an unbounded plane (the level is in [0, width) * [0, height)) and the cells outside the level are not lost. The result is the same of the game only while the pattern doesn't reach the level's borders.
+ The plane levels (board=plane, see SparseLifeEngine) are always loaded in plane mode (setPlaneMode()), also when they are a power of 2 square: then the result is exact.
+
+ The nodes' memory is bounded: when there are more than maxNodes nodes, the unreachable nodes and the cached results are deleted (garbage collection) before the next jump.
+ The bound is also checked during a jump: a jump that reaches it is aborted and split in 2 half jumps, with a garbage collection before them (see boundedJump()).
+
+ The methods are:
+
+ -HashLifeEngine() => it creates the engine with a bound on the number of nodes
+ -load() => it builds the quadtree of the passed level. The level can be placed in the corner of a bigger area (width * height): the big board is never allocated, so a huge sparse level costs only its nodes
+ -setRule() => it sets the rule (the cached results are deleted)
+ -setPlaneMode() => if true, the next levels are loaded on the unbounded plane, also the power of 2 squares
+ -step() => it advances one generation
+ -advance() => it advances n generations (with a jump of 2^j generations for every bit j of n)
+ -get() => it returns the state of the cell (x, y)
+ -set() => it sets the state of the cell (x, y)
+ -countAlive() => it counts the alive cells (every node stores its population)
+ -copyTo() => it writes the level's area in a board
+ -isTorus() => it returns true if the PACMAN effect is exact
+ -getGeneration() => it returns the number of generations computed since load()
+ -getNodeCount() => it returns the number of stored nodes
+ -getMemorySize() => it returns the bytes used by the nodes (approximately, for the hash table)
+ -collectGarbage() => it deletes the nodes that are not used by the current board
+ -jump() => (private) it advances 2^j generations, it returns false if the jump reaches jumpLimit nodes
+ -boundedJump() => (private) a jump of 2^j generations split in smaller jumps until it fits in maxNodes nodes
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class HashLifeEngine : public LifeBackend{
+
+    private:
+        static const uint32_t noNode = 0xFFFFFFFF;
+
+        struct Node{
+            uint32_t nw, ne, sw, se;            //children (level 0 nodes don't have children)
+            uint32_t result;                    //cached central square after 2^resultStep generations (or noNode)
+            int level;
+            int resultStep;
+            uint64_t population;
+        };
+
+        struct NodeKey{
+            uint32_t nw, ne, sw, se;
+            bool operator==(const NodeKey &other) const{
+                return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+            }
+        };
+
+        struct NodeKeyHash{
+            size_t operator()(const NodeKey &key) const{
+                uint64_t hash = key.nw;
+                hash = hash * 0x9E3779B97F4A7C15ULL + key.ne;
+                hash = hash * 0x9E3779B97F4A7C15ULL + key.sw;
+                hash = hash * 0x9E3779B97F4A7C15ULL + key.se;
+                return size_t(hash ^ (hash >> 29));
+            }
+        };
+
+        std::vector<Node> nodes;                //nodes[0] is the dead cell, nodes[1] is the alive cell
+        std::unordered_map<NodeKey, uint32_t, NodeKeyHash> nodeTable;
+        std::vector<uint32_t> emptyNodes;       //the empty node of every level (or noNode)
+        size_t maxNodes;
+        size_t jumpLimit;                       //successor() aborts the jump when there are more nodes (SIZE_MAX => never)
+
+        uint32_t root;
+        bool torus;
+        bool planeMode;                         //true => the levels are never loaded as a torus
+        int width;
+        int height;
+        long generation;
+        LifeRule rule;
+
+        uint32_t newLeaves();
+        uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+        uint32_t emptyNode(int level);
+        uint32_t expand(uint32_t node);
+        uint32_t centre(uint32_t node);
+        uint32_t successor(uint32_t node, int j);
+        uint32_t life4x4(uint32_t node);
+        uint32_t build(const BitBoard &level, int nodeLevel, int fromX, int fromY);
+        bool getCell(uint32_t node, int64_t x, int64_t y) const;
+        uint32_t setCell(uint32_t node, int64_t x, int64_t y, bool alive);
+        void copyCells(uint32_t node, int64_t fromX, int64_t fromY, BitBoard &board) const;
+        uint32_t copyNode(uint32_t node, std::vector<Node> &newNodes, std::vector<uint32_t> &newIndexes) const;
+        int64_t getRootOffset() const;
+        bool jump(int j);
+        void boundedJump(int j);
+
+    public:
+        HashLifeEngine(size_t _maxNodes = 1 << 22);
+        void load(const BitBoard &level) override;
+        void load(const BitBoard &level, int _width, int _height);
+        void setRule(const LifeRule &_rule) override;
+        void setPlaneMode(bool _planeMode);
+        void step() override;
+        void advance(long generations) override;
+        bool get(int x, int y) const override;
+        void set(int x, int y, bool alive) override;
+        long countAlive() const override;
+        void copyTo(BitBoard &board) const override;
+        bool isTorus() const;
+        long getGeneration() const;
+        size_t getNodeCount() const;
+        size_t getMemorySize() const;
+        void collectGarbage();
+
+};
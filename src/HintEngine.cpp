@@ -0,0 +1,223 @@
+#include "HintEngine.hpp"
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+HintEngine::HintEngine(int _maxDepth, long _maxCells){
+    maxDepth = std::max(1, _maxDepth);
+    maxCells = _maxCells;
+}
+
+HintEngine::~HintEngine(){
+    stop();
+}
+
+/*
+ SETSTATE
+
+ It is called by the game's thread: the board is copied in the pending job (the worker only swaps it, so the lock is never held for long), and the running search is stopped by the job counter.
+ The old hint is invalidated immediately: it was computed for the previous grid.
+ The counter is incremented under the hint's lock (see publish()), so a search finishing a round of the previous grid can't overwrite the empty hint.
+*/
+void HintEngine::setState(const BitBoard &board, const LifeRule &rule, int delay, const GameModel::Actor &player, long generation){
+    if(!worker.joinable()){
+        quit = false;
+        worker = std::thread(&HintEngine::run, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        pending.board = board;
+        pending.rule = rule;
+        pending.delay = delay;
+        pending.player = player;
+        pending.generation = generation;
+        hasPending = true;
+
+        Hint empty;                                             //the counter changes under the hint's lock: a search of the old grid can't publish after it
+        empty.generation = generation;
+        std::lock_guard<std::mutex> hintLock(hintMutex);
+        jobCount++;
+        hint = empty;
+    }
+    jobCondition.notify_one();
+}
+
+HintEngine::Hint HintEngine::getHint(){
+    std::lock_guard<std::mutex> lock(hintMutex);
+    return hint;
+}
+
+//the hint is invalidated when the engine stops: the next start shows nothing until the new grid's first depth
+void HintEngine::stop(){
+    if(worker.joinable()){
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            quit = true;
+            jobCount++;                                         //the running search stops
+        }
+        jobCondition.notify_one();
+        worker.join();
+    }
+    clear();
+}
+
+//the pending job is dropped, and the counter changes under the hint's lock like in setState(): the running search can't publish after it (and it stops)
+void HintEngine::clear(){
+    std::lock_guard<std::mutex> lock(jobMutex);
+    hasPending = false;
+    std::lock_guard<std::mutex> hintLock(hintMutex);
+    jobCount++;
+    hint = Hint();
+}
+
+//the hint is written only if its job is still the last one: the check and the write are under the same lock of setState()
+void HintEngine::publish(const Hint &_hint, uint64_t jobId){
+    std::lock_guard<std::mutex> lock(hintMutex);
+    if(jobCount.load() != jobId) return;
+    hint = _hint;
+}
+
+//the job is kept between the iterations: the swap with the pending job reuses the boards' memory
+void HintEngine::run(){
+    Job job;
+    while(true){
+        uint64_t jobId;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCondition.wait(lock, [&](){ return hasPending || quit; });
+            if(quit) return;
+            std::swap(job, pending);
+            hasPending = false;
+            jobId = jobCount.load();
+        }
+        search(job, jobId);
+    }
+}
+
+/*
+ SEARCH
+
+ The candidates of the previous search are replaced by the new ones, but before that the "no shot" candidate looks for its grid among them: if the new grid is the next generation of an old candidate, its simulated generations continue from there.
+ The depth doubles after every round, and the best candidate is published at the end of every round. The search ends at maxDepth or when the best candidate empties the grid within depth (a deeper search can't find an earlier win).
+ A reused candidate can already have more generations than depth: only the first depth generations are compared (see isClear() and getPopulation()), so the rounds are fair.
+*/
+void HintEngine::search(Job &job, uint64_t jobId){
+    const BitBoard &board = job.board;
+    const GameModel::Actor &player = job.player;
+    if(long(board.getWidth()) * board.getHeight() > maxCells || board.countAlive() == 0) return;
+    if(player.x < 0 || player.y < 0 || player.x >= board.getWidth() || player.y >= board.getHeight()) return;
+
+    BitBoard scratch(board.getWidth(), board.getHeight());
+    std::vector<Candidate> nextCandidates(1);
+    Candidate &wait = nextCandidates[0];
+    wait.fire = false;
+    wait.stand = player;
+    wait.board = board;
+
+    uint64_t hash = board.getHash();
+    for(Candidate &old : candidates){
+        if(old.hashes.empty() || old.hashes[0] != hash || old.board.getWidth() != board.getWidth() || old.board.getHeight() != board.getHeight()) continue;
+
+        wait.board = std::move(old.board);
+        wait.populations.assign(old.populations.begin() + 1, old.populations.end());
+        wait.hashes.assign(old.hashes.begin() + 1, old.hashes.end());
+        wait.clearGeneration = old.clearGeneration > 1 ? old.clearGeneration - 1 : -1;
+        if(!wait.populations.empty()){
+            board.nextGeneration(scratch, job.rule);            //the only generation that isn't reused: the player's cell can be different
+            wait.safe = !scratch.get(player.x, player.y);
+        }
+        break;
+    }
+
+    std::vector<GameModel::Target> targets;
+    GameModel::findTargets(board, player, 0, job.delay - 1, targets);      //delay - 1 frames between two generations
+    for(GameModel::Target &target : targets){
+        nextCandidates.emplace_back();
+        Candidate &candidate = nextCandidates.back();
+        candidate.fire = true;
+        candidate.stand = target.shooter;
+        candidate.board = board;
+        candidate.board.set(target.x, target.y, true);
+        candidate.target = std::move(target);
+    }
+    candidates.swap(nextCandidates);
+
+    for(int depth=1; ; depth=std::min(depth * 2, maxDepth)){
+        for(Candidate &candidate : candidates){
+            extend(candidate, depth, job.rule, scratch);
+            if(jobCount.load() != jobId) return;                //a new grid: this search is useless
+        }
+
+        const Candidate *best = &candidates[0];
+        for(const Candidate &candidate : candidates){
+            if(isBetter(candidate, *best, depth)) best = &candidate;
+        }
+
+        Hint result;
+        result.valid = true;
+        result.generation = job.generation;
+        result.fire = best->fire;
+        result.shooter = best->stand;
+        result.fireFrame = best->fire ? best->target.fireFrame : 0;
+        result.targetX = best->fire ? best->target.x : 0;
+        result.targetY = best->fire ? best->target.y : 0;
+        result.depth = depth;
+        result.population = getPopulation(*best, depth);
+        result.clearGeneration = isClear(*best, depth) ? best->clearGeneration : -1;
+        result.safe = best->safe;
+        publish(result, jobId);
+
+        if(depth == maxDepth || isClear(*best, depth)) return;
+    }
+}
+
+//the generations continue from the last simulated one (the previous depth's round or the previous search)
+void HintEngine::extend(Candidate &candidate, int depth, const LifeRule &rule, BitBoard &scratch){
+    while(int(candidate.populations.size()) < depth && candidate.clearGeneration < 0){
+        candidate.board.nextGeneration(scratch, rule);
+        std::swap(candidate.board, scratch);
+        if(candidate.populations.empty()) candidate.safe = !candidate.board.get(candidate.stand.x, candidate.stand.y);
+
+        long population = candidate.board.countAlive();
+        candidate.populations.push_back(population);
+        candidate.hashes.push_back(candidate.board.getHash());
+        if(population == 0) candidate.clearGeneration = int(candidate.populations.size());
+    }
+}
+
+/*
+ ISBETTER
+
+ The order of the candidates:
+    -the player survives the next generation
+    -the grid is empty earlier
+    -fewer alive cells after depth generations
+    -fewer frames (waiting is the fastest)
+*/
+bool HintEngine::isBetter(const Candidate &a, const Candidate &b, int depth){
+    if(a.safe != b.safe) return a.safe;
+
+    int clearA = isClear(a, depth) ? a.clearGeneration : INT_MAX;
+    int clearB = isClear(b, depth) ? b.clearGeneration : INT_MAX;
+    if(clearA != clearB) return clearA < clearB;
+
+    long populationA = getPopulation(a, depth);
+    long populationB = getPopulation(b, depth);
+    if(populationA != populationB) return populationA < populationB;
+
+    int framesA = a.fire ? a.target.endFrame : 0;
+    int framesB = b.fire ? b.target.endFrame : 0;
+    return framesA < framesB;
+}
+
+//true if the candidate's grid is empty within depth generations
+bool HintEngine::isClear(const Candidate &candidate, int depth){
+    return candidate.clearGeneration > 0 && candidate.clearGeneration <= depth;
+}
+
+//the alive cells after depth generations (0 after the grid is empty)
+long HintEngine::getPopulation(const Candidate &candidate, int depth){
+    if(isClear(candidate, depth)) return 0;
+    return candidate.populations[std::min(depth, int(candidate.populations.size())) - 1];
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameModel.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ HINTENGINE
+ The HintEngine class suggests the best next shot during the game: where to stand, which direction to face and when to fire (or not to fire in this generation).
+ The moves and the rockets are the GameModel's rules (GameModel::findTargets(), the same of the LevelSolver).
+
+ The search runs on its own thread, so it never delays Game::update():
+    -after every generation the Game passes the new grid and the player (setState()): the board is copied in a pending job, and the worker takes it with a swap
+    -the candidates are every new enemy cell that the player can create before the next generation, and "no shot"
+    -every candidate's grid is simulated some generations ahead (iterative deepening: 1, 2, 4... up to maxDepth generations). The best candidate leaves the grid empty first, otherwise it has the fewest alive cells at the end. The candidates where the player dies in the next generation are the worst ones
+    -the best candidate is published after every completed depth: getHint() returns the best answer found until now (anytime search)
+
+ A new state stops the current search (an atomic counter is checked after every candidate's generations) and restarts it.
+ The restart is incremental: the simulated generations of the previous search are reused. If the new grid is the next generation of a candidate (the player followed the hint or didn't fire), that candidate's generations become the new "no shot" generations.
+
+ The grids with more than maxCells cells are not searched (too many candidates to store their boards): their hint is never valid.
+
+ The methods are:
+
+ -HintEngine() => it sets the search's limits (the thread is started by the first setState())
+ -~HintEngine() => it stops the thread
+ -setState() => it restarts the search from a new grid (after a generation), the player's cell and direction
+ -getHint() => it returns the best hint found for the last state (valid is false if the search hasn't completed a depth yet)
+ -stop() => it stops and joins the thread, and it clears the hint
+ -clear() => it invalidates the hint and stops the running search (a grid without hints, like a plane level)
+ -run() => (private) the worker's loop: it waits for a job and searches it
+ -search() => (private) the iterative deepening of a job, it returns when the search ends or when a new job arrives
+ -extend() => (private) it simulates a candidate's grid up to depth generations (it continues from the last simulated generation)
+ -isBetter() => (private) the candidates' order
+ -isClear() / getPopulation() => (private) a candidate's result after depth generations
+ -publish() => (private) it writes the hint read by getHint(), if its job hasn't been replaced by a new state
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class HintEngine{
+
+    public:
+        struct Hint{
+            bool valid = false;
+            long generation = -1;               //the generation of the searched grid
+            bool fire = false;                  //false => the best move is waiting (no shot in this generation)
+            GameModel::Actor shooter;           //where to stand and which direction to face
+            int fireFrame = 0;                  //when to fire: frames after the generation (the fastest path from the player's cell)
+            int targetX = 0;                    //the new enemy cell
+            int targetY = 0;
+            int depth = 0;                      //generations simulated ahead
+            long population = 0;                //alive cells after depth generations
+            int clearGeneration = -1;           //generations until the grid is empty (-1 => not within depth)
+            bool safe = false;                  //false => the player dies in the next generation anyway
+        };
+
+        HintEngine(int _maxDepth = 32, long _maxCells = 16384);
+        ~HintEngine();
+        void setState(const BitBoard &board, const LifeRule &rule, int delay, const GameModel::Actor &player, long generation);
+        Hint getHint();
+        void stop();
+        void clear();
+
+    private:
+        struct Job{
+            BitBoard board;
+            LifeRule rule;
+            int delay;
+            GameModel::Actor player;
+            long generation;
+        };
+
+        struct Candidate{
+            bool fire;
+            GameModel::Target target;
+            GameModel::Actor stand;             //the player's cell during the next generation
+            BitBoard board;                     //the last simulated generation
+            std::vector<long> populations;      //alive cells after 1, 2... generations
+            std::vector<uint64_t> hashes;       //hashes after 1, 2... generations (the restart's keys)
+            int clearGeneration = -1;
+            bool safe = true;                   //the player's cell is dead in the next generation
+        };
+
+        int maxDepth;
+        long maxCells;
+
+        std::thread worker;
+        std::mutex jobMutex;                    //only for the swap of the pending job
+        std::condition_variable jobCondition;
+        Job pending;
+        bool hasPending = false;
+        bool quit = false;
+        std::atomic<uint64_t> jobCount{0};      //states received: the search stops when it changes
+
+        std::mutex hintMutex;                   //for the copy of the hint (and the increment of jobCount in setState())
+        Hint hint;
+
+        std::vector<Candidate> candidates;      //the worker's candidates (kept for the next restart)
+
+        void run();
+        void search(Job &job, uint64_t jobId);
+        void extend(Candidate &candidate, int depth, const LifeRule &rule, BitBoard &scratch);
+        static bool isBetter(const Candidate &a, const Candidate &b, int depth);
+        static bool isClear(const Candidate &candidate, int depth);
+        static long getPopulation(const Candidate &candidate, int depth);
+        void publish(const Hint &_hint, uint64_t jobId);
+
+};
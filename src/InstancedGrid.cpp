@@ -0,0 +1,84 @@
+#include "InstancedGrid.hpp"
+
+const long InstancedGrid::maxCells;
+
+/*
+ LOAD
+ 
+ The shader depends on the renderer: GLSL 150 with the programmable renderer, GLSL 120 + GL_ARB_draw_instanced with the default one.
+ The "alive" attribute is bound to a fixed location before the link, so the vbo can use it.
+*/
+bool InstancedGrid::load(){
+    string folder = ofIsGLProgrammableRenderer() ? "shadersGL3/" : "shadersGL2/";
+    
+    bool loaded = shader.setupShaderFromFile(GL_VERTEX_SHADER, folder + "cells.vert") &&
+                  shader.setupShaderFromFile(GL_FRAGMENT_SHADER, folder + "cells.frag");
+    if(loaded){
+        if(ofIsGLProgrammableRenderer()) shader.bindDefaults();
+        shader.bindAttribute(aliveAttributeLocation, "alive");
+        loaded = shader.linkProgram();
+    }
+    
+    if(!loaded){
+        ofLogWarning() << "Instanced grid shader not loaded, the grid is drawn cell by cell." << endl;
+    }
+    return loaded;
+}
+
+/*
+ SETUP
+ 
+ It creates the box (the same box of the Cell class) and allocates the per-instance buffer.
+ It is called when a new level starts.
+*/
+void InstancedGrid::setup(int _width, int _height, int cellSize, ofColor _deadColor, ofColor _aliveColor){
+    width = _width;
+    height = _height;
+    spacing = cellSize * 2;
+    depth = cellSize;
+    deadColor = _deadColor;
+    aliveColor = _aliveColor;
+    
+    ofMesh box = ofMesh::box(cellSize, cellSize, cellSize, 1, 1, 1);
+    vbo.setMesh(box, GL_STATIC_DRAW);
+    numIndices = box.getNumIndices();
+    
+    aliveStates.assign(size_t(width) * height, 0);
+    isAttributeAllocated = false;
+}
+
+//it uploads the alive/dead states (1 float for each cell). The buffer is allocated only at the first upload of the level.
+void InstancedGrid::update(const BitBoard &board){
+    for(int x=0; x<width; x++){
+        for(int y=0; y<height; y++){
+            aliveStates[size_t(x) * height + y] = board.get(x, y) ? 1 : 0;
+        }
+    }
+    
+    if(!isAttributeAllocated){
+        vbo.setAttributeData(aliveAttributeLocation, aliveStates.data(), 1, aliveStates.size(), GL_DYNAMIC_DRAW);
+        vbo.setAttributeDivisor(aliveAttributeLocation, 1);          //1 value for each instance (not for each vertex)
+        isAttributeAllocated = true;
+    }
+    else{
+        vbo.updateAttributeData(aliveAttributeLocation, aliveStates.data(), aliveStates.size());
+    }
+}
+
+//all the grid's cells with a single draw call
+void InstancedGrid::draw(){
+    shader.begin();
+    shader.setUniform1i("gridHeight", height);
+    shader.setUniform1f("spacing", spacing);
+    shader.setUniform1f("depth", depth);
+    shader.setUniform4f("deadColor", deadColor.r, deadColor.g, deadColor.b, deadColor.a);
+    shader.setUniform4f("aliveColor", aliveColor.r, aliveColor.g, aliveColor.b, aliveColor.a);
+    
+    vbo.drawElementsInstanced(GL_TRIANGLES, numIndices, aliveStates.size());
+    
+    shader.end();
+}
+
+bool InstancedGrid::isLoaded(){
+    return shader.isLoaded();
+}
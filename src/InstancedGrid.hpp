@@ -0,0 +1,50 @@
+#pragma once
+#include "ofMain.h"
+#include "BitBoard.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+ 
+ INSTANCEDGRID
+ The InstancedGrid class draws the whole game's grid with a single instanced draw call, instead of one box draw call for each cell.
+ A single box mesh is stored in the GPU and it is drawn once for every cell (an "instance"). The vertex shader (bin/data/shadersGL2 or shadersGL3) moves every instance in its grid position and colors it with the dead or the alive color.
+ The alive/dead states are uploaded as a per-instance attribute buffer (1.0 alive, 0.0 dead), and only when the grid changes (generation ticks and rocket's births).
+ 
+ The methods are:
+ 
+ -load() => it loads the shader, it returns false if the GPU doesn't support instancing (the caller should use the per-cell drawing)
+ -setup() => it creates the box mesh and the per-instance buffer for a width * height grid (up to maxCells cells)
+ -update() => it uploads the alive/dead states of the passed board
+ -draw() => it draws all the cells with one draw call
+ -isLoaded() => it returns true if the shader is loaded
+ 
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class InstancedGrid{
+    
+    private:
+        const int aliveAttributeLocation = 4;   //after the openFrameworks' default attributes (position, color, normal, texcoord)
+    
+        ofShader shader;
+        ofVbo vbo;
+        int numIndices;
+        vector<float> aliveStates;              //per-instance attribute, the instances are ordered column by column (index = x * height + y)
+        bool isAttributeAllocated;
+    
+        int width;
+        int height;
+        float spacing;                          //distance between two cells (a cell and a space)
+        float depth;                            //z position of the cells
+        ofFloatColor deadColor;
+        ofFloatColor aliveColor;
+    
+    public:
+        static const long maxCells = 4096L * 4096;     //bigger grids are not drawn instanced (the per-instance buffer would be too big)
+    
+        bool load();
+        void setup(int _width, int _height, int cellSize, ofColor _deadColor, ofColor _aliveColor);
+        void update(const BitBoard &board);
+        void draw();
+        bool isLoaded();
+    
+};
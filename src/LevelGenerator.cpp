@@ -0,0 +1,304 @@
+#include "LevelGenerator.hpp"
+#include <algorithm>
+#include <bitset>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include "ThreadPool.hpp"
+
+const int LevelGenerator::batchSize;
+
+//the harder levels first (the order doesn't depend on the threads, so the generator is deterministic)
+static bool isHarder(const LevelGenerator::Level &a, const LevelGenerator::Level &b){
+    if(a.difficulty != b.difficulty) return a.difficulty > b.difficulty;
+    if(a.lastPopulation != b.lastPopulation) return a.lastPopulation > b.lastPopulation;
+    return a.index < b.index;
+}
+
+LevelGenerator::LevelGenerator(const GeneratorOptions &_options){
+    options = _options;
+}
+
+/*
+ GENERATE
+
+ The candidates are screened batch after batch. The accepted ones keep only their metrics: when they are too many, only the best ones are kept (more than keep, for the identical grids).
+ At the end the best grids are created again from their indexes.
+*/
+std::vector<LevelGenerator::Level> LevelGenerator::generate(){
+    stats = Stats();
+    std::vector<Level> levels;
+    if(options.width < 1 || options.width > BoardBatch::maxWidth || options.height < 2 || options.generations < 1) return levels;
+    options.maxLifetime = std::max(options.maxLifetime, options.generations);
+
+    ThreadPool threadPool(options.threads);
+    std::vector<Level> accepted;
+    size_t limit = std::max(size_t(options.keep) * 4, size_t(batchSize));
+
+    for(long first=0; first<options.candidates; first+=batchSize){
+        screenBatch(first, int(std::min(long(batchSize), options.candidates - first)), threadPool, accepted);
+        if(accepted.size() > 2 * limit){
+            std::nth_element(accepted.begin(), accepted.begin() + limit, accepted.end(), isHarder);
+            accepted.resize(limit);
+        }
+    }
+    std::sort(accepted.begin(), accepted.end(), isHarder);
+
+    std::unordered_set<uint64_t> grids;
+    for(Level &level : accepted){
+        if(int(levels.size()) >= options.keep) break;
+        seedBoard(level.index, level.board);
+        if(!grids.insert(level.board.getHash()).second) continue;
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+const LevelGenerator::Stats &LevelGenerator::getStats() const{
+    return stats;
+}
+
+/*
+ SEEDBOARD
+
+ Every cell is random only if it is the first of its images (the cells that the symmetry makes equal): the other images copy it.
+ The player's first cell and its images are killed at the end, so the symmetry is kept.
+*/
+LevelGenerator::Symmetry LevelGenerator::seedBoard(long index, BitBoard &board) const{
+    std::seed_seq sequence{uint32_t(options.seed), uint32_t(options.seed >> 32), uint32_t(index), uint32_t(uint64_t(index) >> 32)};
+    std::mt19937_64 random(sequence);
+    std::bernoulli_distribution alive(options.density);
+    Symmetry symmetry = options.symmetry >= 0 && options.symmetry < SYMMETRIES ? Symmetry(options.symmetry) : Symmetry(random() % SYMMETRIES);
+
+    const int width = options.width;
+    const int height = options.height;
+    auto images = [&](int x, int y, int imagesX[4], int imagesY[4]){
+        int count = 0;
+        imagesX[count] = x;
+        imagesY[count++] = y;
+        if(symmetry == MIRROR_X || symmetry == MIRROR_XY){
+            imagesX[count] = width - 1 - x;
+            imagesY[count++] = y;
+        }
+        if(symmetry == MIRROR_Y || symmetry == MIRROR_XY){
+            imagesX[count] = x;
+            imagesY[count++] = height - 1 - y;
+        }
+        if(symmetry == ROTATION || symmetry == MIRROR_XY){
+            imagesX[count] = width - 1 - x;
+            imagesY[count++] = height - 1 - y;
+        }
+        return count;
+    };
+
+    board.resize(width, height);
+    int imagesX[4], imagesY[4];
+    for(int y=0; y<height; y++){
+        for(int x=0; x<width; x++){
+            int count = images(x, y, imagesX, imagesY);
+            int first = 0;
+            for(int i=1; i<count; i++){
+                if(imagesY[i] * width + imagesX[i] < imagesY[first] * width + imagesX[first]) first = i;
+            }
+            if(first == 0) board.set(x, y, alive(random));
+            else board.set(x, y, board.get(imagesX[first], imagesY[first]));
+        }
+    }
+
+    int count = images(width / 2, 1, imagesX, imagesY);         //GameModel::setup()
+    for(int i=0; i<count; i++) board.set(imagesX[i], imagesY[i], false);
+    return symmetry;
+}
+
+const char *LevelGenerator::symmetryName(Symmetry symmetry){
+    switch(symmetry){
+        case MIRROR_X: return "x";
+        case MIRROR_Y: return "y";
+        case MIRROR_XY: return "xy";
+        case ROTATION: return "rotation";
+        default: return "none";
+    }
+}
+
+/*
+ SCREENBATCH
+
+ The boards are seeded and checked by groups of BoardBatch::lanesPerTask lanes: the boards of a group share their words only with each other, so the tasks never write the same word.
+ Every generation is stepped for the whole batch, then every running board is checked (see the class' description). The batch stops early when no board is running.
+*/
+void LevelGenerator::screenBatch(long first, int count, ThreadPool &threadPool, std::vector<Level> &accepted){
+    const int width = options.width;
+    const int height = options.height;
+    const int generations = options.generations;
+    const int maxPopulation = int(options.maxDensity * width * height);
+    const int boardsPerTask = (BoardBatch::maxWidth / width) * BoardBatch::lanesPerTask;
+    const int tasks = (count + boardsPerTask - 1) / boardsPerTask;
+
+    batch.resize(width, height, count);
+    tracks.resize(count);
+    hashes.resize(size_t(count) * (generations + 1));
+    std::vector<int> running(tasks);
+
+    //it checks a generation of the boards of a task, and it counts the boards still running
+    auto check = [&](int task, int generation){
+        int from = task * boardsPerTask;
+        int to = std::min(from + boardsPerTask, count);
+        int stillRunning = 0;
+
+        for(int i=from; i<to; i++){
+            Track &track = tracks[i];
+            if(track.status != RUNNING) continue;
+
+            uint64_t hash = 0;
+            int population = 0;
+            for(int y=0; y<height; y++){
+                uint64_t row = batch.getRow(i, y);
+                hash ^= BitBoard::wordKey(y, row);
+                population += std::bitset<64>(row).count();
+                track.active[y] |= row;
+            }
+            hashes[size_t(i) * (generations + 1) + generation] = hash;
+
+            if(generation == 0){
+                track.population = population;
+                track.anchor = hash;
+                track.anchorGeneration = 0;
+                track.power = 1;
+            }
+            if(population == 0) track.status = EXTINCT;
+            else if(population > maxPopulation) track.status = EXPLODED;
+            else if(generation > 0 && hash == track.anchor){
+                track.status = PERIODIC;
+                track.period = generation - track.anchorGeneration;
+            }
+            else if(generation - track.anchorGeneration == track.power){       //Brent: the anchor moves after 1, 2, 4... generations
+                track.anchor = hash;
+                track.anchorGeneration = generation;
+                track.power *= 2;
+            }
+            if(track.status == RUNNING) stillRunning++;
+        }
+        running[task] = stillRunning;
+    };
+
+    auto seed = [&](int task){
+        int from = task * boardsPerTask;
+        int to = std::min(from + boardsPerTask, count);
+        BitBoard board;
+        for(int i=from; i<to; i++){
+            Track &track = tracks[i];
+            track.status = RUNNING;
+            track.period = 0;
+            track.lifetime = -1;
+            track.symmetry = seedBoard(first + i, board);
+            track.active.assign(height, 0);
+            batch.load(i, board);
+        }
+        check(task, 0);
+    };
+    threadPool.parallelFor(tasks, seed);
+
+    int generation = 0;
+    auto checkGeneration = [&](int task){
+        check(task, generation);
+    };
+    auto isRunning = [&](){
+        for(int stillRunning : running) if(stillRunning > 0) return true;
+        return false;
+    };
+    while(generation < generations && isRunning()){
+        batch.step(1, options.rule, &threadPool);
+        generation++;
+        threadPool.parallelFor(tasks, checkGeneration);
+    }
+
+    std::vector<int> survivors;
+    for(int i=0; i<count; i++) if(tracks[i].status == RUNNING) survivors.push_back(i);
+    auto follow = [&](int s){
+        followSurvivor(survivors[s]);
+    };
+    threadPool.parallelFor(int(survivors.size()), follow);
+
+    //the lifetime is the first generation of the cycle: the first hash equal to the hash period generations later (followSurvivor() has already written it)
+    for(int i=0; i<count; i++){
+        const Track &track = tracks[i];
+        stats.screened++;
+        if(track.status == EXTINCT){
+            stats.extinct++;
+            continue;
+        }
+        if(track.status == EXPLODED){
+            stats.exploded++;
+            continue;
+        }
+
+        bool capped = track.status == RUNNING;
+        int lifetime = track.lifetime;
+        if(track.status == PERIODIC && lifetime < 0){
+            const uint64_t *boardHashes = &hashes[size_t(i) * (generations + 1)];
+            lifetime = 0;
+            while(boardHashes[lifetime] != boardHashes[lifetime + track.period]) lifetime++;
+        }
+        if(lifetime < options.minLifetime){
+            stats.stable++;
+            continue;
+        }
+
+        int activeCells = 0;
+        for(uint64_t row : track.active) activeCells += std::bitset<64>(row).count();
+        stats.accepted++;
+        int lastPopulation = capped ? track.lastPopulation : 0;
+        accepted.push_back({first + i, track.symmetry, BitBoard(), lifetime, track.period, capped, activeCells, track.population, lastPopulation, double(lifetime) * activeCells});
+    }
+}
+
+/*
+ FOLLOWSURVIVOR
+
+ The board continues from the batch's last generation, and the hashes of all its generations are kept (the batch's ones too), with the last generation of every hash.
+ The first hash seen again gives the period (the distance from its last generation), then the lifetime is the first generation equal to the one period generations later, like in screenBatch().
+ The board keeps the status RUNNING only if it reaches maxLifetime: then its lifetime is maxLifetime (capped).
+ It runs on the ThreadPool: it writes only its own track.
+*/
+void LevelGenerator::followSurvivor(int index){
+    Track &track = tracks[index];
+    const int generations = options.generations;
+    const int maxPopulation = int(options.maxDensity * options.width * options.height);
+    const uint64_t *boardHashes = &hashes[size_t(index) * (generations + 1)];
+
+    std::vector<uint64_t> history(boardHashes, boardHashes + generations + 1);
+    std::unordered_map<uint64_t, int> last;
+    last.reserve(options.maxLifetime + 1);
+    for(int generation=0; generation<=generations; generation++) last[history[generation]] = generation;
+
+    BitBoard board, next(options.width, options.height);
+    batch.store(index, board);
+    int population = board.countAlive();
+    for(int generation=generations + 1; generation<=options.maxLifetime; generation++){
+        board.nextGeneration(next, options.rule);
+        std::swap(board, next);
+        population = board.countAlive();
+        for(int y=0; y<options.height; y++) track.active[y] |= board.getRow(y)[0];
+
+        if(population == 0){
+            track.status = EXTINCT;
+            return;
+        }
+        if(population > maxPopulation){
+            track.status = EXPLODED;
+            return;
+        }
+        uint64_t hash = board.getHash();
+        history.push_back(hash);
+        auto found = last.emplace(hash, generation);
+        if(!found.second){
+            track.status = PERIODIC;
+            track.period = generation - found.first->second;
+            track.lifetime = 0;
+            while(history[track.lifetime] != history[track.lifetime + track.period]) track.lifetime++;
+            return;
+        }
+    }
+    track.lifetime = options.maxLifetime;
+    track.lastPopulation = population;
+}
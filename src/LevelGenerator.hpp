@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BoardBatch.hpp"
+
+class ThreadPool;
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LEVELGENERATOR
+ The LevelGenerator class creates new torus levels: it screens many random seeds by simulating them, and it returns the most difficult ones.
+
+ Every candidate is a random grid (density alive cells) with a symmetry: none, mirrored on the columns (x), on the rows (y), on both (xy) or rotated by 180 degrees.
+ The candidate's random generator is seeded with the options' seed and the candidate's index, so a candidate is the same with any number of threads, and its grid can be created again from its index.
+ The player's first cell (GameModel::setup()) is always dead.
+
+ The candidates are simulated in batches of batchSize boards (see BoardBatch), all the boards of a batch in lockstep. After every generation the boards are checked in parallel:
+    -extinct => the grid dies out by itself (rejected)
+    -exploded => more than maxDensity alive cells (rejected)
+    -periodic => the grid repeats itself (Brent's cycle detection on the boards' hashes). Its lifetime is the first generation of the cycle (the hashes of every generation are kept): a lifetime shorter than minLifetime is too easy (rejected)
+ A batch stops when all its boards are checked. The boards still running after the last generation (the survivors, a few of them) are simulated one by one with a BitBoard, up to maxLifetime generations: their cycle is found with the hashes of all their generations.
+ A survivor that doesn't repeat itself within maxLifetime generations has the lifetime maxLifetime and it is marked as capped (it lives at least so long).
+
+ The difficulty of an accepted candidate is its lifetime times its active area (the cells alive in at least one generation before the cycle): long lived grids that spread everywhere are the hardest to clear.
+ The capped candidates can have the same difficulty: the one with more alive cells at the last generation is harder.
+ Only the metrics of the accepted candidates are kept: the grids of the best ones are created again at the end. The identical grids are returned once.
+
+ The methods are:
+
+ -LevelGenerator() => it creates the generator with its options (GeneratorOptions)
+ -generate() => it screens the candidates and returns the keep most difficult levels (the most difficult first)
+ -getStats() => it returns the counters of the last generate()
+ -seedBoard() => it creates the grid of a candidate
+ -symmetryName() => it returns the name of a symmetry (none, x, y, xy, rotation)
+ -screenBatch() => (private) it simulates a batch of candidates and writes the metrics of the accepted ones
+ -followSurvivor() => (private) it simulates a board still running after the batch's generations, until it dies out, explodes, repeats itself or reaches maxLifetime
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct GeneratorOptions{
+    int width = 8;                      //the levels' size (at most BoardBatch::maxWidth columns)
+    int height = 8;
+    long candidates = 100000;           //random grids screened
+    double density = 0.25;              //alive cells of a random grid
+    int symmetry = -1;                  //LevelGenerator::Symmetry, -1 => a random symmetry for every candidate
+    int generations = 256;              //generations simulated in the batches
+    int maxLifetime = 4096;             //max generations of the survivors of the batches (simulated one by one)
+    int minLifetime = 16;               //the grids that repeat themselves earlier are too easy
+    double maxDensity = 0.5;            //the grids with more alive cells (in any generation) explode
+    int keep = 10;                      //levels returned
+    LifeRule rule;
+    uint64_t seed = 1;
+    int threads = 0;                    //0 => one for each CPU core
+};
+
+
+class LevelGenerator{
+
+    public:
+        enum Symmetry{NONE, MIRROR_X, MIRROR_Y, MIRROR_XY, ROTATION, SYMMETRIES};
+
+        struct Level{
+            long index;                         //the candidate's index (seedBoard())
+            Symmetry symmetry;
+            BitBoard board;
+            int lifetime;                       //generations before the cycle (maxLifetime if capped)
+            int period;                         //0 => it didn't repeat itself
+            bool capped;                        //true => it didn't repeat itself within maxLifetime generations (lifetime >= maxLifetime)
+            int activeCells;                    //cells alive in at least one generation
+            int population;                     //alive cells of the level
+            int lastPopulation;                 //alive cells of the last simulated generation (the tie-break of the capped levels)
+            double difficulty;
+        };
+
+        struct Stats{
+            long screened = 0;
+            long extinct = 0;
+            long exploded = 0;
+            long stable = 0;                    //periodic before minLifetime
+            long accepted = 0;
+        };
+
+        static const int batchSize = 4096;      //boards simulated in lockstep
+
+        LevelGenerator(const GeneratorOptions &_options = GeneratorOptions());
+        std::vector<Level> generate();
+        const Stats &getStats() const;
+        Symmetry seedBoard(long index, BitBoard &board) const;
+        static const char *symmetryName(Symmetry symmetry);
+
+    private:
+        enum Status{RUNNING, EXTINCT, EXPLODED, PERIODIC};
+
+        struct Track{                           //a board of the batch during the simulation
+            Status status;
+            Symmetry symmetry;
+            int population;                     //alive cells of the level (generation 0)
+            uint64_t anchor;                    //Brent: the hash compared with the next generations
+            int anchorGeneration;
+            int power;
+            int period;
+            int lifetime;                       //written by followSurvivor() (-1 => the cycle was found in the batch)
+            int lastPopulation;
+            std::vector<uint64_t> active;       //OR of the rows of every generation
+        };
+
+        GeneratorOptions options;
+        Stats stats;
+        BoardBatch batch;
+        std::vector<Track> tracks;
+        std::vector<uint64_t> hashes;           //the hashes of every generation of every board (generations + 1 for each board)
+
+        void screenBatch(long first, int count, ThreadPool &threadPool, std::vector<Level> &accepted);
+        void followSurvivor(int index);
+
+};
@@ -0,0 +1,185 @@
+#include "LevelParser.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+const int LevelParser::maxSize;
+const int LevelParser::defaultDelay;
+const int LevelParser::minDelay;
+
+/*
+ PARSE
+
+ The buffer is read line by line without copying the lines. A header line ("##...") starts a new level, a line that starts with 0 or 1 is a row of the current level.
+ The rows are appended (already packed) to the words of the current level, and the level's board is created when the next header (or the end of the buffer) is found.
+*/
+std::vector<LevelParser::Level> LevelParser::parse(const char *data, size_t size){
+    std::vector<Level> levels;
+    std::vector<uint64_t> words;                //the packed rows of the current level
+    std::vector<uint64_t> row;                  //the row that is being read
+    int width = 0;
+    int height = 0;
+    bool validValues = true;
+    std::string levelError = "";                //if it is not empty, the rows of the level are skipped
+
+    auto finishLevel = [&](){
+        if(levels.empty()) return;
+        Level &level = levels.back();
+
+        if(!validValues) level.errors.push_back("No correct value in the level matrix (the cell is dead).");
+        if(levelError != "") level.errors.push_back(levelError);
+        else if(height > 0){
+            int wordsPerRow = (width + 63) / 64;
+            level.board.resize(width, height);
+            for(int y=0; y<height; y++){
+                std::copy(words.begin() + size_t(y) * wordsPerRow, words.begin() + size_t(y + 1) * wordsPerRow, level.board.getRow(y));
+            }
+        }
+
+        words.clear();
+        width = 0;
+        height = 0;
+        validValues = true;
+        levelError = "";
+    };
+
+    const char *end = data + size;
+    while(data < end){
+        const char *lineEnd = static_cast<const char *>(memchr(data, '\n', end - data));
+        if(lineEnd == nullptr) lineEnd = end;
+        const char *next = lineEnd + 1;
+        if(lineEnd > data && lineEnd[-1] == '\r') lineEnd--;      //Windows line endings
+
+        if(lineEnd - data >= 2 && data[0] == '#' && data[1] == '#'){     //the level's header
+            finishLevel();
+            levels.push_back(Level());
+            parseHeader(data, lineEnd, levels.back());
+        }
+        else if(lineEnd > data && (data[0] == '0' || data[0] == '1') && !levels.empty() && levelError == ""){
+            int cells = parseRow(data, lineEnd, row, validValues);
+
+            if(height == 0) width = cells;
+            if(cells != width){
+                levelError = "error in levels.txt. All the rows of a level must have the same length.";
+            }
+            else if(width > maxSize || height >= maxSize){
+                levelError = "error in levels.txt. Levels can't be bigger than " + std::to_string(maxSize) + "x" + std::to_string(maxSize) + ".";
+            }
+            else{
+                words.insert(words.end(), row.begin(), row.end());
+                height++;
+            }
+        }
+        data = next;
+    }
+    finishLevel();
+
+    return levels;
+}
+
+//it reads the whole file in memory (one allocation) and parses it
+bool LevelParser::parseFile(const std::string &path, std::vector<Level> &levels){
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open()) return false;
+
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    levels = parse(data.data(), data.size());
+    return true;
+}
+
+/*
+ The header has the structure "##delay=240 rule=B36/S23 board=plane" (the rule and the board mode are optional).
+ If the delay is not a valid integer, the delay is the default (240). The delay can't be < 60.
+*/
+void LevelParser::parseHeader(const char *line, const char *lineEnd, Level &level){
+    std::string header(line, lineEnd);
+
+    size_t delayPos = header.find("delay=");
+    const char *delayStr = (delayPos != std::string::npos) ? header.c_str() + delayPos + 6 : nullptr;
+    char *delayEnd = nullptr;
+    long delay = delayStr ? strtol(delayStr, &delayEnd, 10) : 0;
+
+    if(delayStr == nullptr || delayEnd == delayStr){
+        level.errors.push_back("Wrong sintax in a level declaration. This is an example of how should be the line before the level: ##delay=240");
+    }
+    else{
+        level.delay = int(std::max(std::min(delay, 1000000L), long(minDelay)));     //we can't set the levels delay < 60
+    }
+
+    size_t rulePos = header.find("rule=");
+    if(rulePos != std::string::npos){
+        std::string ruleStr = header.substr(rulePos + 5);
+        ruleStr = ruleStr.substr(0, ruleStr.find_first_of(" \t"));
+
+        if(!LifeRule::parse(ruleStr, level.rule)){
+            level.rule = LifeRule::conway();
+            level.errors.push_back("Wrong rule in a level declaration: " + ruleStr + ". This is an example of a valid rule: ##delay=240 rule=B36/S23");
+        }
+    }
+
+    size_t boardPos = header.find("board=");
+    if(boardPos != std::string::npos){
+        std::string boardStr = header.substr(boardPos + 6);
+        boardStr = boardStr.substr(0, boardStr.find_first_of(" \t"));
+
+        if(boardStr == "plane") level.plane = true;
+        else if(boardStr != "torus") level.errors.push_back("Wrong board in a level declaration: " + boardStr + ". The board can be torus (the default) or plane.");
+    }
+}
+
+/*
+ The cells are separated by commas, and the value of a cell is its first non blank char.
+ The cell x is the bit (x % 64) of the word (x / 64) of the row, like in the BitBoard.
+ If a value is not 0 or 1, the cell is dead and validValues becomes false.
+*/
+int LevelParser::parseRow(const char *line, const char *lineEnd, std::vector<uint64_t> &row, bool &validValues){
+    int cells = 0;
+    row.clear();
+
+    const char *cell = line;
+    while(cell < lineEnd){
+        if(cells % 64 == 0) row.push_back(0);
+
+        //fast path: a single char cell ("0," or "1,")
+        if((*cell == '0' || *cell == '1') && (cell + 1 == lineEnd || cell[1] == ',')){
+            row.back() |= uint64_t(*cell - '0') << (cells % 64);
+            cells++;
+            cell += 2;
+            continue;
+        }
+
+        const char *cellEnd = static_cast<const char *>(memchr(cell, ',', lineEnd - cell));
+        if(cellEnd == nullptr) cellEnd = lineEnd;
+
+        const char *value = cell;
+        while(value < cellEnd && (*value == ' ' || *value == '\t')) value++;
+
+        if(value < cellEnd && *value == '1') row.back() |= uint64_t(1) << (cells % 64);
+        else if(value == cellEnd || *value != '0') validValues = false;
+        cells++;
+
+        cell = cellEnd + 1;
+    }
+    return cells;
+}
+
+/*
+ CHECK
+
+ The level can't be played if the parser left its board empty (0 * 0, the rows don't have the same length or the level is too big) or if it doesn't have alive cells.
+ The alive cells are searched 64 cells at a time, and the search stops at the first one.
+*/
+std::string LevelParser::check(const BitBoard &board){
+    if(board.getWidth() == 0 || board.getHeight() == 0){
+        return "error in levels.txt. The level is not valid (it has no rows, or they don't have the same length).";
+    }
+    if(board.getWidth() > maxSize || board.getHeight() > maxSize){
+        return "error in levels.txt. Levels can't be bigger than 16384x16384.";
+    }
+    if(board.isRegionEmpty(0, 0, board.getWidth(), board.getHeight())){
+        return "The levels must have at least 1 alive cell.";
+    }
+    return "";
+}
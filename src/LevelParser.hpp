@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "BitBoard.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LEVELPARSER
+ The LevelParser class parses the levels file (levels.txt).
+
+ Every level starts with a header line, then there is a row of cells for every line (0 dead, 1 alive, separated by commas):
+
+    ##delay=240 rule=B36/S23 board=plane
+    0,0,1,0
+    0,1,1,0
+
+ The rows are packed in 64-bit words while they are read (1 bit for each cell), so there isn't any intermediate matrix: the parse time and the memory grow linearly with the file.
+ The levels can be rectangular (width * height), up to maxSize * maxSize cells.
+ The board mode is optional: "board=torus" (the default, the PACMAN effect) or "board=plane" (an unbounded plane, see SparseLifeEngine).
+
+ The errors don't stop the parsing, they are written in the level's errors:
+    -the delay is not a valid integer => the default delay (240). The delay can't be < 60.
+    -the rule is not valid => Conway's rules (B3/S23)
+    -the board mode is not valid => torus
+    -a cell is not 0 or 1 => a dead cell
+    -the rows don't have the same length, or the level is bigger than maxSize * maxSize => an empty board (0 * 0), the level is not valid
+
+ The methods are:
+
+ -parse() => it parses the levels in a text buffer
+ -parseFile() => it reads a file and parses its levels, it returns false if the file can't be read
+ -check() => it returns the error of a parsed level's board (an empty string if the level can be played)
+ -parseHeader() => (private) it reads the delay, the rule and the board mode of a header line
+ -parseRow() => (private) it packs a row of cells, it returns the number of cells
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class LevelParser{
+
+    public:
+        static const int maxSize = 16384;       //max width and height of a level
+        static const int defaultDelay = 240;
+        static const int minDelay = 60;
+
+        struct Level{
+            BitBoard board;
+            int delay = defaultDelay;
+            LifeRule rule;
+            bool plane = false;                 //true => unbounded plane, false => torus
+            std::vector<std::string> errors;
+        };
+
+        static std::vector<Level> parse(const char *data, size_t size);
+        static bool parseFile(const std::string &path, std::vector<Level> &levels);
+        static std::string check(const BitBoard &board);
+
+    private:
+        static void parseHeader(const char *line, const char *lineEnd, Level &level);
+        static int parseRow(const char *line, const char *lineEnd, std::vector<uint64_t> &row, bool &validValues);
+
+};
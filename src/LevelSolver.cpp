@@ -0,0 +1,232 @@
+#include "LevelSolver.hpp"
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "ThreadPool.hpp"
+
+const size_t LevelSolver::maxProbes;
+
+//fewer alive cells first, then fewer shots (the order doesn't depend on the threads, so the search is deterministic)
+static bool isBetter(long populationA, size_t shotsA, uint64_t keyA, long populationB, size_t shotsB, uint64_t keyB){
+    if(populationA != populationB) return populationA < populationB;
+    if(shotsA != shotsB) return shotsA < shotsB;
+    return keyA < keyB;
+}
+
+LevelSolver::LevelSolver(const SolverOptions &_options){
+    options = _options;
+    delay = 240;
+}
+
+/*
+ SOLVE
+
+ Every layer is a generation:
+    -the states of the frontier are expanded in parallel: their children are ranked by population (only the best beamWidth of every state are kept) and the ones already in the transposition table are discarded
+    -the children of all the states are sorted, and the best ones (not repeated) become the next frontier: their boards are computed by a second parallel expansion of their parents
+ The old layers keep only the parent's index and the shots of every state, for the replay of the solution.
+*/
+LevelSolver::Solution LevelSolver::solve(const BitBoard &level, const LifeRule &_rule, int _delay){
+    rule = _rule;
+    delay = _delay;
+    Solution solution;
+
+    State root;
+    root.board = level;
+    root.player.x = level.getWidth() / 2;                       //GameModel::setup()
+    root.player.y = 1;
+    root.player.dirY = 1;
+    if(level.getWidth() == 0 || level.getHeight() < 2 || level.get(root.player.x, root.player.y)) return solution;      //the player dies in the first frame
+    if(level.countAlive() == 0){
+        replay(level, {{}}, solution);
+        return solution;
+    }
+
+    table.assign(size_t(1) << options.tableBits, 0);
+    insertKey(stateKey(root.board, root.player));
+
+    ThreadPool threadPool(options.threads);
+    std::vector<State> frontier(1, root);
+    std::vector<std::vector<Record>> layers;
+    auto isBetterChild = [](const Child &a, const Child &b){
+        return isBetter(a.population, size_t(a.shots), a.key, b.population, size_t(b.shots), b.key);
+    };
+
+    for(int generation=0; generation<options.maxGenerations && !frontier.empty(); generation++){
+        int firstFrame = generation == 0 ? 1 : 0;
+        std::vector<std::vector<Child>> children(frontier.size());
+        auto rank = [&](int i){
+            int index = 0;
+            BitBoard next(level.getWidth(), level.getHeight());
+            expand(frontier[i], firstFrame, [&](const BitBoard &board, const GameModel::Actor &player, const std::vector<Shot> &shots){
+                int childIndex = index++;
+                board.nextGeneration(next, rule);
+                if(next.get(player.x, player.y)) return;        //the player dies in the generation's frame
+                uint64_t key = stateKey(next, player);
+                if(!containsKey(key)) children[i].push_back({long(next.countAlive()), key, i, childIndex, int(shots.size())});
+            });
+            if(int(children[i].size()) > options.beamWidth){
+                std::nth_element(children[i].begin(), children[i].begin() + options.beamWidth, children[i].end(), isBetterChild);
+                children[i].resize(options.beamWidth);
+            }
+        };
+        threadPool.parallelFor(int(frontier.size()), rank);
+        solution.states += long(frontier.size());
+
+        std::vector<Child> layer;
+        for(const std::vector<Child> &stateChildren : children) layer.insert(layer.end(), stateChildren.begin(), stateChildren.end());
+        std::sort(layer.begin(), layer.end(), isBetterChild);
+
+        //the grid is empty: the level is won at the next generation's frame
+        for(const Child &child : layer){
+            if(child.population > 0) break;
+
+            std::vector<std::vector<Shot>> intervals(1);
+            int index = 0;
+            expand(frontier[child.parent], firstFrame, [&](const BitBoard &, const GameModel::Actor &, const std::vector<Shot> &shots){
+                if(index++ == child.index) intervals[0] = shots;
+            });
+            int parent = child.parent;
+            for(int l=generation-1; l>=0; l--){
+                intervals.push_back(layers[l][parent].shots);
+                parent = layers[l][parent].parent;
+            }
+            std::reverse(intervals.begin(), intervals.end());
+            intervals.emplace_back();
+            if(replay(level, intervals, solution)) return solution;
+        }
+
+        //the next frontier: the children of every parent are sorted by index, so a second expansion writes them in one pass
+        std::vector<std::vector<std::pair<int, int>>> selected(frontier.size());        //child's index, position in the next layer
+        int count = 0;
+        for(const Child &child : layer){
+            if(count >= options.beamWidth) break;
+            if(!insertKey(child.key)) continue;
+            selected[child.parent].push_back({child.index, count++});
+        }
+        std::vector<State> nextFrontier(count);
+        layers.emplace_back(count);
+        std::vector<Record> &records = layers.back();
+        auto build = [&](int i){
+            if(selected[i].empty()) return;
+            std::sort(selected[i].begin(), selected[i].end());
+            size_t next = 0;
+            int index = 0;
+            expand(frontier[i], firstFrame, [&](const BitBoard &board, const GameModel::Actor &player, const std::vector<Shot> &shots){
+                if(next < selected[i].size() && selected[i][next].first == index){
+                    int position = selected[i][next++].second;
+                    nextFrontier[position].board.resize(board.getWidth(), board.getHeight());
+                    board.nextGeneration(nextFrontier[position].board, rule);
+                    nextFrontier[position].player = player;
+                    records[position] = {i, shots};
+                }
+                index++;
+            });
+        };
+        threadPool.parallelFor(int(frontier.size()), build);
+        frontier.swap(nextFrontier);
+    }
+    return solution;
+}
+
+//the shots are enumerated in the same order every time: the children are identified by their index (the visitor receives the board before the generation)
+void LevelSolver::expand(const State &state, int firstFrame, const Visitor &visit) const{
+    std::vector<Shot> shots;
+    expandShots(state.board, state.player, firstFrame, shots, visit);
+}
+
+/*
+ EXPANDSHOTS
+
+ The board is the grid before the generation, with the cells of the rockets already fired. It is visited (no more shots), then every rocket that can land before the generation is added.
+ The visitor computes the generation only if it needs it (the second expansion only for the kept children).
+ The frames are counted from the first frame after the last generation. In the level's first interval they start from 1: the rocket gets its direction in the first update, so it can't be fired before.
+*/
+void LevelSolver::expandShots(const BitBoard &board, const GameModel::Actor &player, int frame, std::vector<Shot> &shots, const Visitor &visit) const{
+    visit(board, player, shots);
+    if(int(shots.size()) >= options.shotsPerGeneration) return;
+
+    std::vector<GameModel::Target> targets;
+    GameModel::findTargets(board, player, frame, delay - 1, targets);        //delay - 1 frames between two generations
+
+    BitBoard next = board;
+    for(GameModel::Target &target : targets){
+        next.set(target.x, target.y, true);
+        shots.push_back({std::move(target.moves)});
+        expandShots(next, target.shooter, target.endFrame, shots, visit);
+        shots.pop_back();
+        next.set(target.x, target.y, false);
+    }
+}
+
+/*
+ REPLAY
+
+ The shots of every interval (between two generations) are played on a GameModel: every key is pressed as soon as the model accepts it, and the rocket flies until it becomes a cell.
+ It returns false if a shot doesn't end before its generation or the level isn't won at the end (the search and the model don't agree).
+*/
+bool LevelSolver::replay(const BitBoard &level, const std::vector<std::vector<Shot>> &intervals, Solution &solution) const{
+    GameModel model;
+    model.setup(level, rule, delay);
+    std::vector<Input> inputs;
+    int shots = 0;
+
+    auto press = [&](GameModel::Key key){
+        while(!model.canPress() && model.getStatus() == GameModel::PLAYING) model.frame();
+        inputs.push_back({model.getFrame(), key});
+        model.press(key);
+        model.frame();
+    };
+
+    for(size_t i=0; i<intervals.size(); i++){
+        long generationFrame = long(i + 1) * delay - 1;
+        for(const Shot &shot : intervals[i]){
+            for(GameModel::Key key : shot.moves) press(key);
+            if(model.getFrame() == 0) model.frame();            //the rocket has no direction before the first update
+            press(GameModel::SPACE);
+            while(model.isRocketFlying() && model.getStatus() == GameModel::PLAYING) model.frame();
+            shots++;
+        }
+        if(model.getFrame() > generationFrame) return false;
+        while(model.getFrame() <= generationFrame && model.getStatus() == GameModel::PLAYING) model.frame();
+        if(model.getStatus() == GameModel::DEAD) return false;
+    }
+    if(model.getStatus() != GameModel::WON) return false;
+
+    solution.solved = true;
+    solution.generations = int(intervals.size()) - 1;
+    solution.shots = shots;
+    solution.frames = model.getFrame() - 1;
+    solution.inputs = inputs;
+    return true;
+}
+
+//the board's Zobrist hash and a key for the player's cell and direction (a word index that the boards don't have)
+uint64_t LevelSolver::stateKey(const BitBoard &board, const GameModel::Actor &player){
+    uint64_t cell = 1 + player.x + uint64_t(board.getWidth()) * (player.y + uint64_t(board.getHeight()) * ((player.dirX + 1) * 3 + player.dirY + 1));
+    return (board.getHash() ^ BitBoard::wordKey(~size_t(0), cell)) | 1;      //0 is an empty slot of the table
+}
+
+//linear probing: it returns false if the key was already in the table (if the probed slots are all full, the key isn't stored)
+bool LevelSolver::insertKey(uint64_t key){
+    size_t mask = table.size() - 1;
+    for(size_t i=0; i<maxProbes; i++){
+        uint64_t &slot = table[(key + i) & mask];
+        if(slot == key) return false;
+        if(slot == 0){
+            slot = key;
+            return true;
+        }
+    }
+    return true;
+}
+
+bool LevelSolver::containsKey(uint64_t key) const{
+    size_t mask = table.size() - 1;
+    for(size_t i=0; i<maxProbes; i++){
+        uint64_t slot = table[(key + i) & mask];
+        if(slot == key) return true;
+        if(slot == 0) return false;
+    }
+    return false;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "GameModel.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LEVELSOLVER
+ The LevelSolver class searches the keys that win a level (a torus level of levels.txt), to know if a hand-made level can be won.
+ It uses the GameModel's rules (the same rules of the Environment).
+
+ The grid changes only every delay frames, so the search advances one generation at a time. Between two generations the player can move and fire some rockets:
+    -the moves are a shortest path (in frames) from the player's cell and direction to the firing cell and direction, through the dead cells. A turn costs GameModel::rotationFrames frames (the keys are ignored during the camera's rotation), a step forward 1 frame
+    -a rocket becomes an enemy cell where GameModel::flight() says, and it must land before the next generation
+    -only the best way (the fewest frames) to create each new cell is kept
+ The states after every generation are searched breadth first, with a beam: the beamWidth states with fewest alive cells are kept for the next generation. The states are expanded in parallel (ThreadPool), every task writes only its own children.
+ The children are ranked without their boards (only the population and the key): the boards of the kept children are computed again by a second expansion of their parents, so the memory doesn't grow with the children.
+ A transposition table (the board's Zobrist hash and the player's cell and direction) removes the states already found. It is a fixed open-addressing table (2^tableBits keys): when it is full, the new states are not stored (the memory is bounded, the search only repeats some states).
+
+ The level is won when the grid has no alive cells at a generation's frame: the solution is the shots until the generation that leaves the grid empty.
+ The solution's keys are replayed on a GameModel from the beginning of the level, frame by frame, so the returned keys are checked with the real rules.
+
+ The methods are:
+
+ -LevelSolver() => it creates the solver with its limits (SolverOptions: generations, beam, shots between two generations, table's size, threads)
+ -solve() => it searches a solution, it returns the keys and the frames when they must be pressed (solved is false if it isn't found)
+ -expand() => (private) it calls a function for every state after the next generation of a state (every combination of shots), always in the same order
+ -expandShots() => (private) it adds a shot (recursively, up to shotsPerGeneration shots) for every new cell of GameModel::findTargets()
+ -replay() => (private) it plays the solution's shots on a GameModel and writes the keys with their frames
+ -stateKey() => (private) it returns the transposition table's key of a state
+ -insertKey() / containsKey() => (private) the transposition table
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct SolverOptions{
+    int maxGenerations = 64;            //the solution must win within these generations
+    int beamWidth = 512;                //states kept after every generation
+    int shotsPerGeneration = 2;         //max rockets fired between two generations
+    int tableBits = 22;                 //the transposition table has 2^tableBits keys (8 bytes each)
+    int threads = 0;                    //0 => one for each CPU core
+};
+
+
+class LevelSolver{
+
+    public:
+        struct Input{
+            long frame;                         //the key is pressed before this frame's update (the first frame is 0)
+            GameModel::Key key;
+        };
+
+        struct Solution{
+            bool solved = false;
+            int generations = 0;                //the generations before the win
+            int shots = 0;
+            long frames = 0;                    //the frame of the win
+            long states = 0;                    //states expanded by the search
+            std::vector<Input> inputs;
+        };
+
+        LevelSolver(const SolverOptions &_options = SolverOptions());
+        Solution solve(const BitBoard &level, const LifeRule &rule = LifeRule::conway(), int delay = 240);
+
+    private:
+        struct Shot{
+            std::vector<GameModel::Key> moves;  //the keys before the SPACE key
+        };
+
+        struct State{
+            BitBoard board;                     //the grid after a generation
+            GameModel::Actor player;
+        };
+
+        struct Child{                           //a state after the next generation, without its board (see expand())
+            long population;
+            uint64_t key;
+            int parent;                         //index of the parent state in its layer
+            int index;                          //the order of the child among the parent's children
+            int shots;
+        };
+
+        typedef std::function<void(const BitBoard &board, const GameModel::Actor &player, const std::vector<Shot> &shots)> Visitor;
+
+        struct Record{                          //a state of an old layer (only what the solution's replay needs)
+            int parent;
+            std::vector<Shot> shots;
+        };
+
+        static const size_t maxProbes = 32;     //slots probed in the transposition table
+
+        SolverOptions options;
+        LifeRule rule;
+        int delay;
+        std::vector<uint64_t> table;
+
+        void expand(const State &state, int firstFrame, const Visitor &visit) const;
+        void expandShots(const BitBoard &board, const GameModel::Actor &player, int frame, std::vector<Shot> &shots, const Visitor &visit) const;
+        bool replay(const BitBoard &level, const std::vector<std::vector<Shot>> &intervals, Solution &solution) const;
+        static uint64_t stateKey(const BitBoard &board, const GameModel::Actor &player);
+        bool insertKey(uint64_t key);
+        bool containsKey(uint64_t key) const;
+
+};
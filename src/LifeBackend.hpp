@@ -0,0 +1,54 @@
+#pragma once
+#include "BitBoard.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LIFEBACKEND
+ LifeBackend is the interface of the simulation backends (the Environment's grid is advanced by one of them):
+    -LifeEngine => double-buffered bit boards, one generation at a time (the game)
+    -HashLifeEngine => quadtree memoization, it jumps ahead 2^k generations in one step (previews and offline checks)
+    -SparseLifeEngine => an unbounded plane made of 64x64 chunks, only the chunks with alive cells are stored and computed
+
+ The GenerationStats struct is the stats record of a generation (population, births and deaths), the backends that count them while they compute the generations return it with getStats().
+
+ The methods are:
+
+ -load() => it loads a level (a width * height board)
+ -setRule() => it sets the rule of the next generations (Conway's rules by default)
+ -step() => it advances one generation
+ -advance() => it advances n generations (by default step() is called n times)
+ -get() => it returns the state of the cell (x, y)
+ -set() => it sets the state of the cell (x, y)
+ -countAlive() => it counts the alive cells
+ -copyTo() => it writes the current generation in a board (the board has the level's size)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct GenerationStats{
+    long generation = 0;                        //generations computed since load()
+    long population = 0;                        //alive cells of the current generation
+    long births = 0;                            //cells born in the last generation
+    long deaths = 0;                            //cells dead in the last generation
+    long addedCells = 0;                        //cells set alive from outside after the last generation (the rocket's births)
+    long removedCells = 0;                      //cells killed from outside after the last generation
+    uint64_t hash = 0;                          //Zobrist hash of the current generation (updated with the changed words, see BitBoard::wordKey())
+};
+
+
+class LifeBackend{
+
+    public:
+        virtual ~LifeBackend(){}
+        virtual void load(const BitBoard &level) = 0;
+        virtual void setRule(const LifeRule &rule) = 0;
+        virtual void step() = 0;
+        virtual void advance(long generations){
+            for(long g=0; g<generations; g++) step();
+        }
+        virtual bool get(int x, int y) const = 0;
+        virtual void set(int x, int y, bool alive) = 0;
+        virtual long countAlive() const = 0;
+        virtual void copyTo(BitBoard &board) const = 0;
+
+};
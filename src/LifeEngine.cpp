@@ -0,0 +1,274 @@
+#include "LifeEngine.hpp"
+#include <algorithm>
+
+/*
+ it allocates the two boards and the tiles' flags. If the size is the same of the previous level, the old storage is reused.
+ All the tiles are marked as changed, so the first generation is computed on the whole board.
+*/
+void LifeEngine::setup(int width, int height){
+    clearCycle();
+    boards[0].resize(width, height);
+    boards[1].resize(width, height);
+    front = 0;
+    
+    tilesX = boards[0].getWordsPerRow();
+    tilesY = (height + tileRows - 1) / tileRows;
+    changedTiles.assign(size_t(tilesX) * tilesY, 1);
+    nextChangedTiles.assign(size_t(tilesX) * tilesY, 0);
+    bandActiveTiles.assign(tilesY, 0);
+    bandBirths.assign(tilesY, 0);
+    bandDeaths.assign(tilesY, 0);
+    bandHashes.assign(tilesY, 0);
+    stats = GenerationStats();
+    countAllocations();
+}
+
+void LifeEngine::load(const BitBoard &level){
+    setup(level.getWidth(), level.getHeight());
+    
+    int wordsPerRow = level.getWordsPerRow();
+    for(int y=0; y<level.getHeight(); y++){
+        std::copy(level.getRow(y), level.getRow(y) + wordsPerRow, boards[front].getRow(y));
+    }
+    stats.population = level.countAlive();                  //the only scans of the board
+    stats.hash = level.getHash();
+}
+
+//the board must be the one of the stats (a rewind's snapshot): the game continues from that generation
+void LifeEngine::restore(const BitBoard &board, const GenerationStats &_stats){
+    load(board);
+    stats = _stats;
+}
+
+void LifeEngine::setRule(const LifeRule &_rule){
+    rule = _rule;
+}
+
+const LifeRule &LifeEngine::getRule() const{
+    return rule;
+}
+
+/*
+ STEP
+
+ The next generation of the active tiles is written in the back board, then the back board becomes the front board.
+ The skipped tiles are not written: in the back board they already have the same state of the front board.
+ If the board has more than one band and more than one thread is allowed, the bands are computed in parallel.
+ The stats are summed band by band at the end, so the threads don't share counters.
+*/
+void LifeEngine::step(){
+    Tracer::Scope trace("LifeEngine::step");
+    if(replaying){                                          //the generation is already in the cycle's cache
+        long generation = stats.generation + 1;
+        stats = cycleStats[cycleIndex];
+        stats.generation = generation;
+        cycleIndex = (cycleIndex + 1) % cyclePeriod;
+        return;
+    }
+    
+    if(tilesY > 1 && threadCount != 1){
+        if(!threadPool) threadPool.reset(new ThreadPool(threadCount));
+        
+        auto band = [this](int tileY){ stepBand(tileY); };
+        threadPool->parallelFor(tilesY, band);
+    }
+    else{
+        for(int tileY=0; tileY<tilesY; tileY++) stepBand(tileY);
+    }
+    
+    activeTileCount = 0;
+    stats.births = 0;
+    stats.deaths = 0;
+    for(int tileY=0; tileY<tilesY; tileY++){
+        activeTileCount += bandActiveTiles[tileY];
+        stats.births += bandBirths[tileY];
+        stats.deaths += bandDeaths[tileY];
+        stats.hash ^= bandHashes[tileY];
+    }
+    stats.population += stats.births - stats.deaths;
+    stats.addedCells = 0;
+    stats.removedCells = 0;
+    stats.generation++;
+    
+    changedTiles.swap(nextChangedTiles);
+    front = 1 - front;
+    
+    //recording the cycle: the boards have the same size, so the copies don't allocate
+    if(cyclePeriod > 0){
+        cycleBoards[cycleIndex] = boards[front];
+        cycleStats[cycleIndex] = stats;
+        cycleIndex++;
+        
+        if(cycleIndex == cyclePeriod){
+            if(stats.hash == cycleStartHash){           //the cycle is confirmed: the next generation is the first cached one
+                replaying = true;
+                cycleIndex = 0;
+            }
+            else{
+                clearCycle();
+            }
+        }
+    }
+    countAllocations();
+}
+
+//it computes the active tiles of the band tileY (rows from tileY * tileRows to (tileY + 1) * tileRows - 1)
+void LifeEngine::stepBand(int tileY){
+    Tracer::Scope trace("LifeEngine::stepBand");              //the bands are computed by the ThreadPool's threads
+    const BitBoard &current = boards[front];
+    BitBoard &next = boards[1 - front];
+    int fromY = tileY * tileRows;
+    int toY = std::min(fromY + tileRows, current.getHeight());
+    int activeTiles = 0;
+    long births = 0;
+    long deaths = 0;
+    uint64_t hash = 0;
+    
+    for(int tileX=0; tileX<tilesX; tileX++){
+        unsigned char &changed = nextChangedTiles[size_t(tileY) * tilesX + tileX];
+        
+        if(isTileActive(tileX, tileY)){
+            TileChanges tileChanges;
+            changed = current.nextTile(next, tileX, fromY, toY, rule, &tileChanges);
+            births += tileChanges.births;
+            deaths += tileChanges.deaths;
+            hash ^= tileChanges.hash;
+            activeTiles++;
+        }
+        else{
+            changed = 0;
+        }
+    }
+    bandActiveTiles[tileY] = activeTiles;
+    bandBirths[tileY] = births;
+    bandDeaths[tileY] = deaths;
+    bandHashes[tileY] = hash;
+}
+
+//the tile is active if it or one of its 8 neighbours (with the PACMAN effect) changed in the last generation
+bool LifeEngine::isTileActive(int tileX, int tileY) const{
+    for(int dy=-1; dy<=1; dy++){
+        int y = (tileY + dy + tilesY) % tilesY;
+        
+        for(int dx=-1; dx<=1; dx++){
+            int x = (tileX + dx + tilesX) % tilesX;
+            if(changedTiles[size_t(y) * tilesX + x]) return true;
+        }
+    }
+    return false;
+}
+
+bool LifeEngine::get(int x, int y) const{
+    return getCurrentBoard().get(x, y);
+}
+
+//the tile of the cell is woken up, so it and its neighbours are computed in the next generation. If the cell doesn't change, nothing happens.
+void LifeEngine::set(int x, int y, bool alive){
+    if(get(x, y) == alive) return;
+    
+    clearCycle();                                           //the cycle is broken
+    
+    size_t wordIndex = size_t(y) * tilesX + x / 64;
+    uint64_t prevWord = boards[front].getRow(y)[x / 64];
+    boards[front].set(x, y, alive);
+    stats.hash ^= BitBoard::wordKey(wordIndex, prevWord) ^ BitBoard::wordKey(wordIndex, boards[front].getRow(y)[x / 64]);
+    if(alive){
+        stats.population++;
+        stats.addedCells++;
+    }
+    else{
+        stats.population--;
+        stats.removedCells++;
+    }
+    changedTiles[size_t(y / tileRows) * tilesX + x / 64] = 1;
+}
+
+const BitBoard &LifeEngine::getBoard() const{
+    return getCurrentBoard();
+}
+
+const BitBoard &LifeEngine::getCurrentBoard() const{
+    if(replaying) return cycleBoards[(cycleIndex + cyclePeriod - 1) % cyclePeriod];       //the last replayed generation
+    return boards[front];
+}
+
+long LifeEngine::countAlive() const{
+    return stats.population;
+}
+
+const GenerationStats &LifeEngine::getStats() const{
+    return stats;
+}
+
+void LifeEngine::copyTo(BitBoard &board) const{
+    board = getCurrentBoard();
+}
+
+size_t LifeEngine::getMemorySize() const{
+    size_t memorySize = boards[0].getMemorySize() + boards[1].getMemorySize();
+    for(const BitBoard &board : cycleBoards) memorySize += board.getMemorySize();
+    return memorySize;
+}
+
+long LifeEngine::getAllocationCount() const{
+    return allocationCount;
+}
+
+//only the engine's two boards are checked (the cycle's cache is allocated on purpose by cacheCycle())
+void LifeEngine::countAllocations(){
+    for(int b=0; b<2; b++){
+        if(boards[b].getCapacity() != capacities[b]) allocationCount++;
+        capacities[b] = boards[b].getCapacity();
+    }
+}
+
+int LifeEngine::getActiveTileCount() const{
+    return activeTileCount;
+}
+
+/*
+ CACHECYCLE
+ 
+ It is called when the current generation was already seen "period" generations ago: the next "period" generations are recorded (while they are computed as usual).
+ If after them the hash is the same of now, the cycle is confirmed and the next generations are replayed from the records (the generation step becomes free).
+ The boards are allocated here (not in step()), and only if the cycle fits in maxCycleMemory.
+*/
+bool LifeEngine::cacheCycle(int period){
+    clearCycle();
+    if(period <= 0 || size_t(period) * boards[front].getMemorySize() > maxCycleMemory) return false;
+    
+    cycleBoards.assign(period, boards[front]);
+    cycleStats.assign(period, stats);
+    cyclePeriod = period;
+    cycleIndex = 0;
+    cycleStartHash = stats.hash;
+    return true;
+}
+
+bool LifeEngine::isReplaying() const{
+    return replaying;
+}
+
+//if the generations are replayed, the last replayed generation becomes the front board, and all the tiles are computed in the next generation (the back board is old)
+void LifeEngine::clearCycle(){
+    if(replaying){
+        boards[front] = getCurrentBoard();
+        std::fill(changedTiles.begin(), changedTiles.end(), 1);
+    }
+    cycleBoards.clear();
+    cycleStats.clear();
+    cyclePeriod = 0;
+    cycleIndex = 0;
+    replaying = false;
+}
+
+//the threads are created again (at the next step) only if the number changes
+void LifeEngine::setThreadCount(int _threadCount){
+    if(_threadCount == threadCount) return;
+    threadCount = _threadCount;
+    threadPool.reset();
+}
+
+int LifeEngine::getThreadCount() const{
+    return threadPool ? threadPool->getThreadCount() : std::max(threadCount, 1);
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <memory>
+#include "LifeBackend.hpp"
+#include "ThreadPool.hpp"
+#include "Tracer.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LIFEENGINE
+ The LifeEngine class advances the game's grid generation after generation (it is the game's LifeBackend).
+ It keeps two preallocated boards (front and back): the next generation is written in the back board, then the two boards are swapped. So, after setup(), the game doesn't allocate anything while it is playing.
+
+ The board is split in tiles (one 64-bit word wide, tileRows rows high) and every tile has a "changed" flag. If a tile and its 8 neighbour tiles didn't change in the last generation, the tile can't change in the next one, so it is skipped.
+ A skipped tile is already correct in the back board: the back board contains the previous generation, which is the same as the current one in that tile.
+ The cells set from outside (the rocket's births) wake up their tile.
+
+ The population and the births/deaths of every generation are counted while the tiles are computed (GenerationStats), so nobody has to scan the board to know how many cells are alive.
+ The cells set from outside update the population too. The same is done for the board's Zobrist hash: only the changed words update it.
+ 
+ When the board is periodic (the Environment finds a repeated hash, see CycleDetector), cacheCycle() stores the next generations of the cycle: if the cycle is confirmed, the next generations are not computed anymore, they are replayed from the cache until a cell is set from outside.
+
+ The rows of tiles (bands) are independent tasks: on big boards they are computed in parallel by a persistent ThreadPool (threads are not created for every generation).
+ Every band reads only the front board (the neighbour rows are read directly, with the PACMAN effect) and writes only its rows of the back board, so the result is the same of the serial computation, bit by bit.
+
+ The methods are:
+
+ -setup() => it allocates the two boards (all the cells are dead)
+ -load() => it allocates the two boards and copies the passed level in the front board
+ -restore() => same as load(), but the stats (and the generation's number) are the passed ones (a rewind)
+ -setRule() => it sets the rule (the kernel is selected in BitBoard::nextTile())
+ -getRule() => it returns the rule
+ -step() => it computes the next generation (only the active tiles) and swaps the front and the back boards
+ -get() => it returns the state of the cell (x, y) of the current generation
+ -set() => it sets the state of the cell (x, y) of the current generation
+ -getBoard() => it returns the current generation (the front board)
+ -countAlive() => it returns the alive cells of the current generation (it doesn't scan the board)
+ -getStats() => it returns the stats of the last generation (population, births, deaths)
+ -copyTo() => it copies the current generation in another board
+ -getMemorySize() => it returns the bytes used by the two boards
+ -getAllocationCount() => it returns how many times its two boards have been (re)allocated (it must not change after setup()). The counter belongs to the engine, so the boards of other threads (the hints, the solver) don't change it
+ -getActiveTileCount() => it returns the number of tiles computed in the last generation
+ -cacheCycle() => it records the next "period" generations, then they are replayed (it returns false if the cycle is too big to be cached)
+ -isReplaying() => it returns true if the generations are replayed from the cycle's cache
+
+ -setThreadCount() => it sets the number of threads (0 => one for each CPU core, 1 => serial)
+ -getThreadCount() => it returns the number of threads
+ -stepBand() => (private) it computes a row of tiles
+ -isTileActive() => (private) it returns true if the tile or one of its neighbours changed in the last generation
+ -getCurrentBoard() => (private) it returns the current generation (the front board, or the cached board while replaying)
+ -countAllocations() => (private) it counts the boards whose storage has changed since the last check
+ -clearCycle() => (private) it deletes the cycle's cache (the replayed generation is copied in the front board), the next generations are computed again
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class LifeEngine : public LifeBackend{
+
+    private:
+        const int tileRows = 64;                //rows of a tile (a tile is 64 * 64 cells)
+
+        BitBoard boards[2];
+        int front = 0;                          //index of the current generation's board
+        size_t capacities[2] = {0, 0};          //the boards' capacities at the last check
+        long allocationCount = 0;               //the changes of the boards' capacities
+        LifeRule rule;
+
+        int tilesX;                             //n. of tiles in a row (== words per row)
+        int tilesY;                             //n. of tiles in a column
+        std::vector<unsigned char> changedTiles;        //1 if the tile changed in the last generation
+        std::vector<unsigned char> nextChangedTiles;    //the flags of the generation that is being computed
+        std::vector<int> bandActiveTiles;      //active tiles of every band (summed after the parallel step)
+        std::vector<long> bandBirths;           //births of every band (summed after the parallel step)
+        std::vector<long> bandDeaths;           //deaths of every band (summed after the parallel step)
+        std::vector<uint64_t> bandHashes;       //hash changes of every band (XORed after the parallel step)
+        int activeTileCount = 0;
+        GenerationStats stats;
+
+        const size_t maxCycleMemory = 64 << 20; //max bytes of the cycle's cache
+        std::vector<BitBoard> cycleBoards;      //the generations of the cycle
+        std::vector<GenerationStats> cycleStats;
+        int cyclePeriod = 0;                    //0 => there isn't a cycle's cache
+        int cycleIndex = 0;                     //the next generation to record (or to replay)
+        uint64_t cycleStartHash = 0;            //the hash that must come back after "period" generations
+        bool replaying = false;
+
+        int threadCount = 0;
+        std::unique_ptr<ThreadPool> threadPool;         //created at the first parallel step
+
+        void stepBand(int tileY);
+        bool isTileActive(int tileX, int tileY) const;
+        const BitBoard &getCurrentBoard() const;
+        void clearCycle();
+        void countAllocations();
+
+    public:
+        void setup(int width, int height);
+        void load(const BitBoard &level) override;
+        void restore(const BitBoard &board, const GenerationStats &_stats);
+        void setRule(const LifeRule &_rule) override;
+        const LifeRule &getRule() const;
+        void step() override;
+        bool get(int x, int y) const override;
+        void set(int x, int y, bool alive) override;
+        const BitBoard &getBoard() const;
+        long countAlive() const override;
+        const GenerationStats &getStats() const;
+        void copyTo(BitBoard &board) const override;
+        size_t getMemorySize() const;
+        long getAllocationCount() const;
+        int getActiveTileCount() const;
+        bool cacheCycle(int period);
+        bool isReplaying() const;
+        void setThreadCount(int _threadCount);
+        int getThreadCount() const;
+
+};
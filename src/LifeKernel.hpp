@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include "LifeRule.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LIFEKERNEL
+ The LifeKernel struct computes 64 cells at a time with bitwise adders. It is shared by the boards that store the cells in 64-bit words (BitBoard, SparseLifeEngine and BoardBatch): they only have to find the neighbour words (with the PACMAN effect or not).
+
+ The next state of a cell depends only on its state and on its neighbours count (0..8). For every count, the rule's lookup table says if a dead cell is born and if an alive cell survives.
+    -StaticRule => the table is built at compile time (constexpr) from the rule's masks, so the compiler removes the unused counts and every rule gets its own kernel (the Conway's kernel costs like a Conway-only one)
+    -DynamicRule => the table is read at runtime (any other rule)
+
+ The methods are:
+
+ -selectRule() => it calls the passed function with the StaticRule of the rule (or with a DynamicRule if the rule is not specialized)
+ -nextCells() => it computes the next state of 64 cells from the 3 rows around them
+ -countCells() => the next state of the cells with n neighbours (a term of nextCells())
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct LifeKernel{
+
+    //the lookup table's entry of the count n: bit 0 => birth, bit 1 => survival
+    static constexpr int ruleEntry(uint16_t birth, uint16_t survival, int n){
+        return ((birth >> n) & 1) | (((survival >> n) & 1) << 1);
+    }
+
+    template<uint16_t birth, uint16_t survival>
+    struct StaticRule{
+        constexpr int entry(int n) const{
+            return ruleEntry(birth, survival, n);
+        }
+    };
+
+    struct DynamicRule{
+        int table[9];
+
+        DynamicRule(const LifeRule &rule){
+            for(int n=0; n<=8; n++) table[n] = ruleEntry(rule.birth, rule.survival, n);
+        }
+        int entry(int n) const{
+            return table[n];
+        }
+    };
+
+    //the specialized rules (they cost nothing more than the Conway's one)
+    typedef StaticRule<(1 << 3), (1 << 2) | (1 << 3)> ConwayRule;                                                               //B3/S23
+    typedef StaticRule<(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)> HighLifeRule;                                                  //B36/S23
+    typedef StaticRule<(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8), (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)> DayAndNightRule;   //B3678/S34678
+    typedef StaticRule<(1 << 2), 0> SeedsRule;                                                                                  //B2/S
+    typedef StaticRule<(1 << 3), 0x1FF> LifeWithoutDeathRule;                                                                   //B3/S012345678
+    typedef StaticRule<(1 << 3), (1 << 1) | (1 << 2) | (1 << 3) | (1 << 4) | (1 << 5)> MazeRule;                                //B3/S12345
+
+    template<class Rule>
+    static bool isRule(const LifeRule &rule){
+        Rule staticRule;
+        for(int n=0; n<=8; n++){
+            if(staticRule.entry(n) != ruleEntry(rule.birth, rule.survival, n)) return false;
+        }
+        return true;
+    }
+
+    //the rule is selected once, then the function (usually a loop over many words) runs with the specialized kernel
+    template<class Function>
+    static auto selectRule(const LifeRule &rule, Function &&function) -> decltype(function(ConwayRule())){
+        if(isRule<ConwayRule>(rule)) return function(ConwayRule());
+        if(isRule<HighLifeRule>(rule)) return function(HighLifeRule());
+        if(isRule<DayAndNightRule>(rule)) return function(DayAndNightRule());
+        if(isRule<SeedsRule>(rule)) return function(SeedsRule());
+        if(isRule<LifeWithoutDeathRule>(rule)) return function(LifeWithoutDeathRule());
+        if(isRule<MazeRule>(rule)) return function(MazeRule());
+        return function(DynamicRule(rule));
+    }
+
+    //the next state of the cells with n neighbours (counts are the 4 bits of the neighbours count of every cell)
+    template<class Rule>
+    static uint64_t countCells(int n, const uint64_t counts[4], uint64_t alive, const Rule &rule){
+        int entry = rule.entry(n);
+        if(entry == 0) return 0;
+
+        uint64_t equals = ((n & 1) ? counts[0] : ~counts[0]) & ((n & 2) ? counts[1] : ~counts[1]) &
+                          ((n & 4) ? counts[2] : ~counts[2]) & ((n & 8) ? counts[3] : ~counts[3]);
+        if(entry == 3) return equals;
+        if(entry == 1) return equals & ~alive;
+        return equals & alive;
+    }
+
+    /*
+     NEXTCELLS
+
+     The 8 neighbours of 64 cells are 8 words: the 3 rows (up, current, down) shifted of one bit to the left (left[r], the bit x contains the cell x-1), not shifted (center[r]) and shifted to the right (right[r], the bit x contains the cell x+1).
+     These words are summed with bitwise adders: first the 3 horizontal neighbours of every row (a 2 bits number), then the 3 rows. count0, count1, count2 and count3 are the 4 bits of the neighbours count of every cell (from 0 to 8).
+    */
+    template<class Rule>
+    static uint64_t nextCells(const uint64_t left[3], const uint64_t center[3], const uint64_t right[3], const Rule &rule){
+        //horizontal sums of the 3 rows (bit 0 and bit 1), the current cell is not calculated as a neighbour
+        uint64_t sum0[3] = {left[0] ^ center[0] ^ right[0], left[1] ^ right[1], left[2] ^ center[2] ^ right[2]};
+        uint64_t sum1[3] = {(left[0] & center[0]) | (right[0] & (left[0] ^ center[0])), left[1] & right[1],
+                            (left[2] & center[2]) | (right[2] & (left[2] ^ center[2]))};
+
+        //count = sum0 (the 3 rows) + 2 * sum1 (the 3 rows)
+        uint64_t count0 = sum0[0] ^ sum0[1] ^ sum0[2];
+        uint64_t carry = (sum0[0] & sum0[1]) | (sum0[2] & (sum0[0] ^ sum0[1]));
+
+        //the twos: sum1[0] + sum1[1] + sum1[2] + carry (from 0 to 4)
+        uint64_t a = sum1[0] ^ sum1[1], b = sum1[0] & sum1[1];
+        uint64_t c = sum1[2] ^ carry, d = sum1[2] & carry;
+        uint64_t count1 = a ^ c;
+        uint64_t e = a & c;
+        uint64_t count2 = b ^ d ^ e;
+        uint64_t count3 = (b & d) | (b & e) | (d & e);
+
+        //the rule's lookup table: for every neighbours count, the cells with that count are born and/or survive (the 9 counts are written one by one, so the unused ones are removed at compile time)
+        uint64_t alive = center[1];
+        uint64_t counts[4] = {count0, count1, count2, count3};
+        uint64_t next = countCells(0, counts, alive, rule) | countCells(1, counts, alive, rule) | countCells(2, counts, alive, rule) |
+                        countCells(3, counts, alive, rule) | countCells(4, counts, alive, rule) | countCells(5, counts, alive, rule) |
+                        countCells(6, counts, alive, rule) | countCells(7, counts, alive, rule) | countCells(8, counts, alive, rule);
+        return next;
+    }
+
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ LIFERULE
+ The LifeRule struct is a "life-like" cellular automaton rule, written as a rulestring: B<birth counts>/S<survival counts>.
+    -Conway's Game of Life => B3/S23 (the default)
+    -HighLife => B36/S23
+    -Day & Night => B3678/S34678
+ The counts are stored as bit masks: the bit n is 1 if a cell with n neighbours is born (birth) or survives (survival).
+ Rules with B0 (dead cells with no neighbours become alive) are not supported: the empty parts of the board must stay empty.
+
+ The methods are:
+
+ -conway() => it returns the Conway's Game of Life rule
+ -parse() => it parses a rulestring, it returns false if the rulestring is not valid
+ -toString() => it returns the rulestring
+ -isBirth() / isSurvival() => they return true if a cell with n neighbours is born / survives
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct LifeRule{
+
+    uint16_t birth = 1 << 3;
+    uint16_t survival = (1 << 2) | (1 << 3);
+
+    static LifeRule conway(){
+        return LifeRule();
+    }
+
+    static bool parse(const std::string &ruleString, LifeRule &rule){
+        LifeRule parsed;
+        parsed.birth = 0;
+        parsed.survival = 0;
+        uint16_t *mask = nullptr;
+
+        for(char c : ruleString){
+            if(c == 'B' || c == 'b') mask = &parsed.birth;
+            else if(c == 'S' || c == 's') mask = &parsed.survival;
+            else if(c == '/') mask = nullptr;
+            else if(c >= '0' && c <= '8' && mask != nullptr) *mask |= 1 << (c - '0');
+            else return false;
+        }
+        if(parsed.birth & 1) return false;              //B0 is not supported
+
+        rule = parsed;
+        return true;
+    }
+
+    std::string toString() const{
+        std::string ruleString = "B";
+        for(int n=0; n<=8; n++) if(isBirth(n)) ruleString += char('0' + n);
+        ruleString += "/S";
+        for(int n=0; n<=8; n++) if(isSurvival(n)) ruleString += char('0' + n);
+        return ruleString;
+    }
+
+    bool isBirth(int n) const{
+        return (birth >> n) & 1;
+    }
+
+    bool isSurvival(int n) const{
+        return (survival >> n) & 1;
+    }
+
+    bool operator==(const LifeRule &other) const{
+        return birth == other.birth && survival == other.survival;
+    }
+
+    bool operator!=(const LifeRule &other) const{
+        return !(*this == other);
+    }
+
+};
@@ -38,3 +38,22 @@ void Player::controls(string control){
 ofPoint Player::getDirection(){
     return dir;
 }
+
+ActorState Player::getState(){
+    ActorState state;
+    state.x = pos.x;
+    state.y = pos.y;
+    state.dirX = dir.x;
+    state.dirY = dir.y;
+    state.alive = alive;
+    return state;
+}
+
+//the body's colors and position are updated too
+void Player::setState(const ActorState &state){
+    pos = ofPoint(state.x, state.y, pos.z);
+    dir = ofPoint(state.dirX, state.dirY);
+    if(state.alive) giveBirth();
+    else kill();
+    update();
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "ofMain.h"
 #include "Cell.hpp"
+#include "RewindBuffer.hpp"
 
 /*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
  
@@ -12,6 +13,8 @@
  -Player() => it calls the parent contructor, overrides the colors and gives birth to the cell
  -controls() => it allows to change the Player's direction
  -getDirection() => it returns the Player's direction
+ -getState() => it returns the position, the direction and the state of the Player (a rewind's snapshot)
+ -setState() => it restores a state returned by getState()
  
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
@@ -24,5 +27,7 @@ class Player : public Cell{
         Player(ofPoint pos, int size);
         void controls(string control);
         ofPoint getDirection();
+        ActorState getState();
+        void setState(const ActorState &state);
     
 };
@@ -0,0 +1,191 @@
+#include "RewindBuffer.hpp"
+#include <algorithm>
+
+RewindBuffer::RewindBuffer(size_t _maxMemory, size_t _maxGenerations, int _keyframeInterval){
+    maxMemory = _maxMemory;
+    maxGenerations = _maxGenerations;
+    keyframeInterval = _keyframeInterval;
+    ring.resize(std::max<size_t>(maxGenerations, 1));
+}
+
+//the snapshots are deleted, the boards and the buffers keep their storage (the next level has usually the same size)
+void RewindBuffer::clear(){
+    while(count > 0){
+        count--;
+        release(at(count));
+    }
+    first = 0;
+}
+
+RewindBuffer::Snapshot &RewindBuffer::at(size_t i){
+    return ring[(first + i) % ring.size()];
+}
+
+void RewindBuffer::reuse(Snapshot &snapshot){
+    spareSize -= snapshot.data.capacity() * sizeof(uint64_t);
+}
+
+//the snapshot's slot is already free (count doesn't include it)
+void RewindBuffer::release(Snapshot &snapshot){
+    memorySize -= snapshotSize(snapshot);
+    size_t bytes = snapshot.data.capacity() * sizeof(uint64_t);
+    if(getMemorySize() + bytes <= maxMemory) spareSize += bytes;
+    else std::vector<uint64_t>().swap(snapshot.data);
+}
+
+/*
+ RECORD
+
+ The snapshot is a keyframe if it is the first one, if the board's size changed or if the last keyframe is keyframeInterval generations old. Otherwise it is the delta with the last recorded board.
+ A keyframe is also added when the deltas after the last one are as big as a board (a chaotic board changes most of its words every generation): so a restore never applies more than about 2 boards of words.
+ If the ring is full, the oldest snapshot is deleted first; then the oldest snapshots are deleted until the whole buffer (getMemorySize(), the working boards too) is within maxMemory (the newest snapshot is always kept).
+*/
+void RewindBuffer::record(const BitBoard &board, const GenerationStats &stats, const ActorState &player, const ActorState &rocket){
+    if(board.getWidth() != lastBoard.getWidth() || board.getHeight() != lastBoard.getHeight()) clear();
+    if(count == ring.size()) dropOldest();                 //before the encoding: a new keyframe is encoded in the same buffer
+
+    bool keyframe = true;
+    int deltas = 0;                                         //the deltas after the last keyframe
+    size_t deltasSize = 0;                                  //their encoded words
+    for(size_t i=count; i>0; i--){
+        const Snapshot &snapshot = at(i - 1);
+        if(snapshot.keyframe){
+            keyframe = deltas + 1 >= keyframeInterval || deltasSize >= size_t(board.getWordsPerRow()) * board.getHeight();
+            break;
+        }
+        deltas++;
+        deltasSize += snapshot.data.size();
+    }
+    encode(board, keyframe ? nullptr : &lastBoard);
+
+    Snapshot &snapshot = at(count);
+    count++;
+    reuse(snapshot);
+    snapshot.stats = stats;
+    snapshot.player = player;
+    snapshot.rocket = rocket;
+    snapshot.keyframe = keyframe;
+    snapshot.data.assign(encoded.begin(), encoded.end());  //it allocates only if the slot's buffer is too small
+    memorySize += snapshotSize(snapshot);
+    lastBoard = board;                                      //the same size: the storage is reused
+
+    while(getMemorySize() > maxMemory && count > 1) dropOldest();
+}
+
+/*
+ RESTORE
+
+ The board is rebuilt from the nearest keyframe before the snapshot (the oldest snapshot is always a keyframe), applying the deltas up to the snapshot.
+*/
+const RewindBuffer::Snapshot *RewindBuffer::restore(size_t generationsBack, BitBoard &board){
+    if(generationsBack >= count) return nullptr;
+
+    size_t target = count - 1 - generationsBack;
+    size_t keyframe = target;
+    while(!at(keyframe).keyframe) keyframe--;
+
+    board.resize(lastBoard.getWidth(), lastBoard.getHeight());      //all the cells are dead
+    for(size_t i=keyframe; i<=target; i++) apply(at(i).data, board);
+    return &at(target);
+}
+
+//the restored snapshot becomes the newest one: the next recorded generation is its delta
+const RewindBuffer::Snapshot *RewindBuffer::rewind(size_t generationsBack, BitBoard &board){
+    if(!restore(generationsBack, board)) return nullptr;
+
+    for(size_t i=0; i<generationsBack; i++){
+        count--;
+        release(at(count));
+    }
+    lastBoard = board;
+    return &at(count - 1);
+}
+
+size_t RewindBuffer::size() const{
+    return count;
+}
+
+//the snapshots, the kept buffers, the free slots and the working boards (the last recorded board, the keyframes' scratch board and the encoding's buffer)
+size_t RewindBuffer::getMemorySize() const{
+    return memorySize + spareSize + (ring.size() - count) * sizeof(Snapshot) + lastBoard.getMemorySize() + scratch.getMemorySize() + encoded.capacity() * sizeof(uint64_t);
+}
+
+/*
+ ENCODE
+
+ The words are compared with the previous board's words (or with a dead board if prev is nullptr). Every run of changed words is written after a header with the number of unchanged words before it and the number of changed words.
+ The unchanged words after the last run are not written.
+*/
+void RewindBuffer::encode(const BitBoard &board, const BitBoard *prev){
+    encoded.clear();
+    size_t count = size_t(board.getWordsPerRow()) * board.getHeight();
+    if(count == 0) return;
+
+    const uint64_t *words = board.getRow(0);                //the rows are contiguous
+    const uint64_t *prevWords = prev ? prev->getRow(0) : nullptr;
+    auto delta = [&](size_t i){ return prevWords ? words[i] ^ prevWords[i] : words[i]; };
+
+    size_t i = 0;
+    while(i < count){
+        size_t zeros = 0;
+        while(i < count && delta(i) == 0){
+            zeros++;
+            i++;
+        }
+        if(i == count) break;
+
+        size_t header = encoded.size();
+        encoded.push_back(0);
+        size_t literals = 0;
+        while(i < count && delta(i) != 0){
+            encoded.push_back(delta(i));
+            literals++;
+            i++;
+        }
+        encoded[header] = (uint64_t(zeros) << 32) | literals;     //a board has less than 2^32 words
+    }
+}
+
+void RewindBuffer::apply(const std::vector<uint64_t> &data, BitBoard &board){
+    if(board.getHeight() == 0) return;
+
+    uint64_t *words = board.getRow(0);
+    size_t i = 0;
+    size_t pos = 0;
+    while(pos < data.size()){
+        uint64_t header = data[pos++];
+        i += size_t(header >> 32);
+        size_t literals = size_t(header & 0xFFFFFFFF);
+        for(size_t l=0; l<literals; l++) words[i++] ^= data[pos++];
+    }
+}
+
+size_t RewindBuffer::snapshotSize(const Snapshot &snapshot){
+    return sizeof(Snapshot) + snapshot.data.capacity() * sizeof(uint64_t);
+}
+
+/*
+ DROPOLDEST
+
+ If the second snapshot is a delta, it can't be restored without the oldest one: its board is rebuilt in the scratch board and it is encoded again as a keyframe.
+ The new keyframe takes the oldest snapshot's buffer (a keyframe's buffer, so usually big enough), and the oldest one takes the delta's buffer: a keyframe doesn't allocate every generation.
+*/
+void RewindBuffer::dropOldest(){
+    Snapshot &oldest = at(0);
+    if(count > 1 && !at(1).keyframe){
+        Snapshot &next = at(1);
+        scratch.resize(lastBoard.getWidth(), lastBoard.getHeight());
+        apply(oldest.data, scratch);
+        apply(next.data, scratch);
+        encode(scratch, nullptr);
+
+        memorySize -= snapshotSize(oldest) + snapshotSize(next);
+        oldest.data.swap(next.data);
+        next.data.assign(encoded.begin(), encoded.end());
+        next.keyframe = true;
+        memorySize += snapshotSize(oldest) + snapshotSize(next);
+    }
+    first = (first + 1) % ring.size();
+    count--;
+    release(oldest);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "LifeBackend.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ REWINDBUFFER
+ The RewindBuffer class stores the last generations of a level (the board, its stats, the player and the rocket), so the game can go back in time without loading the level again.
+
+ Most of the snapshots are deltas: the XOR of the board's words with the previous generation. A generation changes only a few words, so the XOR is almost all zeros and it is run-length encoded:
+    [zeros << 32 | literals] [literal words...] [zeros << 32 | literals] [literal words...] ...
+ Every keyframeInterval generations (or earlier, if the deltas are as big as a board) there is a keyframe: the board itself, with the same encoding. A snapshot is restored from the nearest older keyframe, applying at most keyframeInterval - 1 deltas (on a 1024 * 1024 board this is under 1 ms).
+
+ The buffer is a ring of maxGenerations snapshots: when it is full or it has more than maxMemory bytes, the oldest snapshot is deleted (if the next one is a delta, it becomes a keyframe).
+ The ring's slots are allocated once and a deleted snapshot keeps its words' buffer, which is reused by the next recorded generation: after the first laps a generation is recorded without allocations.
+ maxMemory limits the whole buffer, not only the stored history: the kept buffers and the working boards (the last recorded board, the scratch board and the encoding's buffer) count in it too, and a kept buffer that doesn't fit is freed.
+ The newest snapshot is always kept, so a maxMemory smaller than a few boards is exceeded.
+ The player and the rocket are a few numbers, they are stored as they are in every snapshot.
+
+ The methods are:
+
+ -RewindBuffer() => it creates the buffer with its limits (memory, generations and keyframes' interval)
+ -clear() => it deletes all the snapshots (a new level)
+ -record() => it adds the snapshot of a generation
+ -restore() => it writes the board of the snapshot "generationsBack" generations ago, it returns the snapshot (nullptr if it isn't stored)
+ -rewind() => same as restore(), but the newer snapshots are deleted (the game continues from the restored one)
+ -size() => it returns the number of stored snapshots
+ -getMemorySize() => it returns all the bytes used by the buffer (the ones limited by maxMemory)
+ -encode() => (private) it run-length encodes the XOR of two boards' words (or the words of a board)
+ -apply() => (private) it XORs an encoded snapshot on a board
+ -dropOldest() => (private) it deletes the oldest snapshot
+ -at() => (private) it returns the i-th stored snapshot (0 => the oldest)
+ -reuse() => (private) the buffer of a free slot is used by a new snapshot
+ -release() => (private) the buffer of a deleted snapshot is kept for the next ones (or freed, if it doesn't fit in maxMemory)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct ActorState{
+    float x = 0;                                //position in the world
+    float y = 0;
+    float dirX = 0;                             //direction
+    float dirY = 0;
+    float parentX = 0;                          //the position of the linked cell (the rocket's player)
+    float parentY = 0;
+    bool alive = false;
+};
+
+
+class RewindBuffer{
+
+    public:
+        struct Snapshot{
+            GenerationStats stats;
+            ActorState player;
+            ActorState rocket;
+            bool keyframe = false;
+            std::vector<uint64_t> data;         //the encoded board (keyframe) or XOR with the previous board (delta)
+        };
+
+        RewindBuffer(size_t _maxMemory = 32 * 1024 * 1024, size_t _maxGenerations = 1024, int _keyframeInterval = 32);
+        void clear();
+        void record(const BitBoard &board, const GenerationStats &stats, const ActorState &player, const ActorState &rocket);
+        const Snapshot *restore(size_t generationsBack, BitBoard &board);
+        const Snapshot *rewind(size_t generationsBack, BitBoard &board);
+        size_t size() const;
+        size_t getMemorySize() const;
+
+    private:
+        std::vector<Snapshot> ring;             //maxGenerations slots, the stored snapshots go from first to first + count - 1 (modulo the size)
+        size_t first = 0;                       //the slot of the oldest snapshot
+        size_t count = 0;                       //the stored snapshots
+        BitBoard lastBoard;                     //the board of the newest snapshot (the next delta is computed from it)
+        BitBoard scratch;                       //the board rebuilt when the oldest snapshot becomes a keyframe
+        std::vector<uint64_t> encoded;          //the encoding buffer (reused)
+        size_t maxMemory;
+        size_t maxGenerations;
+        int keyframeInterval;
+        size_t memorySize = 0;                  //bytes of the stored snapshots
+        size_t spareSize = 0;                   //bytes of the buffers kept in the free slots
+
+        void encode(const BitBoard &board, const BitBoard *prev);
+        static void apply(const std::vector<uint64_t> &data, BitBoard &board);
+        static size_t snapshotSize(const Snapshot &snapshot);
+        void dropOldest();
+        Snapshot &at(size_t i);
+        void reuse(Snapshot &snapshot);
+        void release(Snapshot &snapshot);
+
+};
@@ -65,3 +65,24 @@ ofPoint Rocket::getDirection(){
     return dir;
 }
 
+ActorState Rocket::getState(){
+    ActorState state;
+    state.x = pos.x;
+    state.y = pos.y;
+    state.dirX = dir.x;
+    state.dirY = dir.y;
+    state.parentX = parentPos.x;
+    state.parentY = parentPos.y;
+    state.alive = shooting;
+    return state;
+}
+
+//kill() moves the rocket to the player's position, so the position is restored after it
+void Rocket::setState(const ActorState &state){
+    dir = ofPoint(state.dirX, state.dirY);
+    parentPos = ofPoint(state.parentX, state.parentY, pos.z);              //the z is the same for all the cells
+    if(state.alive) giveBirth();
+    else kill();
+    pos = ofPoint(state.x, state.y, pos.z);
+    body.setPosition(pos);
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "ofMain.h"
 #include "Cell.hpp"
+#include "RewindBuffer.hpp"
 
 /*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
  
@@ -16,6 +17,8 @@
  -giveBirth() => same parent's method, with the addition of the shooting = true
  -kill() => same parent's method, with the addition of the shooting = false
  -getDirection() => it returns the rocket's direction
+ -getState() => it returns the position, the direction, the player's position and the shooting state of the rocket (a rewind's snapshot)
+ -setState() => it restores a state returned by getState()
  
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
@@ -33,6 +36,8 @@ class Rocket : public Cell{
         void giveBirth();                               //overrided method
         void kill();                                    //overrided method
         ofPoint getDirection();
+        ActorState getState();
+        void setState(const ActorState &state);
 
     
 };
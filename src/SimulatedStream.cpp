@@ -0,0 +1,64 @@
+#include "SimulatedStream.hpp"
+
+SimulatedStream::~SimulatedStream(){
+    stop();
+}
+
+//the buffer is allocated here: the stream's thread never allocates
+void SimulatedStream::start(int _sampleRate, int _bufferSize, int _nChannels, int _queuedBuffers, Callback _callback){
+    stop();
+    sampleRate = _sampleRate > 0 ? _sampleRate : 44100;
+    bufferSize = _bufferSize > 0 ? _bufferSize : 512;
+    nChannels = _nChannels > 0 ? _nChannels : 2;
+    queuedBuffers = _queuedBuffers > 0 ? _queuedBuffers : 1;
+    callback = _callback;
+    buffer.assign(size_t(bufferSize) * nChannels, 0.0f);
+    callbacks.store(0);
+    underruns.store(0);
+
+    running.store(true);
+    thread = std::thread(&SimulatedStream::run, this);
+}
+
+void SimulatedStream::stop(){
+    running.store(false);
+    if(thread.joinable()) thread.join();
+}
+
+bool SimulatedStream::isRunning() const{
+    return running.load();
+}
+
+long SimulatedStream::getCallbacks() const{
+    return callbacks.load(std::memory_order_relaxed);
+}
+
+long SimulatedStream::getUnderruns() const{
+    return underruns.load(std::memory_order_relaxed);
+}
+
+/*
+ RUN
+
+ The device starts with its queue full (silent buffers): the buffer n of the callbacks is played at origin + (n + queuedBuffers) periods.
+ After an underrun the device restarts from the late buffer, so the origin moves forward by the gap.
+*/
+void SimulatedStream::run(){
+    const std::chrono::duration<double> period(double(bufferSize) / sampleRate);
+    Clock::time_point origin = Clock::now();
+
+    for(long n=0; running.load(std::memory_order_relaxed); n++){
+        Clock::time_point ready = origin + std::chrono::duration_cast<Clock::duration>(period * double(n));
+        std::this_thread::sleep_until(ready);
+
+        callback(buffer.data(), bufferSize, nChannels);
+        callbacks.store(n + 1, std::memory_order_relaxed);
+
+        Clock::time_point played = origin + std::chrono::duration_cast<Clock::duration>(period * double(n + queuedBuffers));
+        Clock::time_point end = Clock::now();
+        if(end > played){
+            underruns.store(underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            origin += end - played;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ SIMULATEDSTREAM
+ The SimulatedStream class is a sound stream without a sound device: it calls an audio callback on its own thread, on the timer of a real device (like ofSoundStreamSetup() with the same sample rate, buffer size and queued buffers).
+ The audio path (AudioMonitor, BlockSynth) can be measured and tested with it without a sound card (see stream/StreamSimulator.cpp).
+
+ The device is modeled as a queue of queuedBuffers buffers: it plays a buffer every period (bufferSize / sampleRate seconds), and the callback refills the buffer just played.
+    -the callback n starts when the device takes the buffer n - queuedBuffers (or immediately, if it is late)
+    -its buffer is played queuedBuffers periods later: if the callback ends after that time, the device plays a gap (an underrun), and it waits for the late buffer (the following ones are late as much as it)
+ So a callback longer than the period doesn't always cause an underrun: the queue absorbs it if the next callbacks are short enough.
+
+ The methods are:
+
+ -~SimulatedStream() => it stops the stream
+ -start() => it starts the stream's thread (it stops the previous one)
+ -stop() => it stops the stream's thread, after the callback in progress
+ -isRunning() => it returns true if the stream's thread is running
+ -getCallbacks() => it returns the callbacks called since start()
+ -getUnderruns() => it returns the gaps played by the device since start()
+ -run() => (private) the stream's thread
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class SimulatedStream{
+
+    public:
+        using Callback = std::function<void(float *output, int bufferSize, int nChannels)>;
+
+        ~SimulatedStream();
+        void start(int _sampleRate, int _bufferSize, int _nChannels, int _queuedBuffers, Callback _callback);
+        void stop();
+        bool isRunning() const;
+        long getCallbacks() const;
+        long getUnderruns() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        int sampleRate = 44100;
+        int bufferSize = 512;
+        int nChannels = 2;
+        int queuedBuffers = 4;
+        Callback callback;
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+        std::atomic<long> callbacks{0};
+        std::atomic<long> underruns{0};
+        std::vector<float> buffer;
+
+        void run();
+
+};
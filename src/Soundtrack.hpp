@@ -1,18 +1,21 @@
 #pragma once
 #include "ofMain.h"
 #include "ofxMaxim.h"
+#include "Tracer.hpp"
+#include "BoardTripleBuffer.hpp"
+#include "BlockSynth.hpp"
 
 /*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
  
  SOUNDTRACK
  
- This class uses ofxMaxim addon ( https://github.com/falcon4ever/ofxMaxim ).
+ This class uses ofxMaxim addon ( https://github.com/falcon4ever/ofxMaxim ) for the sample rate. The sound is rendered by the BlockSynth class, a whole buffer at a time, with the same oscillators and envelopes of the maxiOsc and maxiEnv keys.
 
  The Soundtrack Class handles the game's soundtrack. The game's grid is treated like a sequencer: the x axis is the time axis and the y axis is like a "keyboard" (or a piano) that plays only harmonics. I choose harmonics because they sound good when played at the same time.
  
  The game's enemies in this class represent the keyboard's keys!
  If they are alive, the keyboard's keys are pressed (and there is a sound), otherwise the keys are not pressed (and there is no sound).
-    Every time setMatrix(matrix) is called, the Soundtrack class changes its to play harmonics.
+    Every time setBoard(board) is called, the Soundtrack class changes its to play harmonics.
  
         ^
         | 0,0,0,1
@@ -21,73 +24,37 @@
         | 0,0,1,0
         |----TIME---->
  
+ The board is passed from the game's thread to the audio thread with a triple buffer (see BoardTripleBuffer): play() never locks, never allocates and never sees a half written board.
+ The keyboard and the buffer's boards are allocated by setup() for the biggest level, before the sound stream starts, so the audio thread only reads them.
+ 
  The methods are:
  
- -setup() => it sets the matrix
- -setMatrix() => it sets the matrix
- -play() => it sums all the frequencies and send them to the outputs channels
+ -setup() => it allocates the keyboard and the boards for the biggest level (it must be called before the sound stream starts)
+ -setBoard() => (game's thread) it passes the new grid to the audio thread
+ -play() => (audio thread) it renders the keyboard's buffer and sends it to the outputs channels
  -SoundtrackClose() => it closes the soundstream
- -setToPlayKeys() => it sets the on and off keyboard's keys
- -setVerticalKeyboard() => it sets the "keyboard" according to initFreq and numOfFreq
- 
-
- KEY
- Key is a tiny class and it is useful for storing:
-    -the Oscillator (repeating waveform with a fundamental frequency)
-    -the Envelope (the attack, sustain, and decay of a sound)
- 
+ -setVoiceLimit() => it sets the max harmonics played at once (the keys with the same harmonic are one voice, see BlockSynth)
+ -setVerticalKeyboard() => it sets the "keyboard" according to keyboardOptions (see BlockSynth::harmonicFrequencies())
  
  --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
 
 
-class Key{
-    private:
-        maxiOsc osc;
-        maxiEnv env;
-        double frequency;
-    
-    public:
-        Key(double _f){
-            frequency = _f;
-        }
-        // Envelope's parameters are: input, attack, release, holdtime, trigger
-        inline double play(){
-            return env.ar(osc.sinewave(frequency), 0.1, 0.1, 1, env.trigger);
-        }
-        //after on() is called, if we call play(), we get an oscillating number.
-        inline void on(){
-            return env.trigger = 1;
-        }
-        //after off() is called, if we call play(), we get a stable number.
-        inline void off(){
-            return env.trigger = 0;
-        }
-};
-
 class Soundtrack{
     
     private:
-        const int beatsPerSecond = 8;           //the "sequencer"'s speed
-        const int initFreq = 100;               //the lowest frequency
-        const int numOfFreq = 5;                //number of used harmonics, if the matrix's height is bigger than this number, the harmonics are repeated( this happens in setVerticalKeyboard() )
-    
-        maxiOsc timer;                          //the timer oscillator
-        int currentCount;
-    
-        maxiMix mix;                            //stereo bus
+        KeyboardOptions keyboardOptions;        //the "sequencer"'s speed (8 columns a second), the harmonics (5 harmonics of 100 Hz, repeated on the rows) and the max harmonics played at once (8)
     
-        int currentToPlayColumnIndx;            //the current "sequencer" column index. If this is 0, the sequencer will play the 0th matrix's column, if this is 5, it will play the 5th, ...
-        vector<Key> verticalKeyboard;           //all the keyboard's keys (n. keys == n. matrix's rows)
-        vector<vector<bool>>soundMatrix;        //this is the Environment's matrix obtained by calling getBoolLifeMatrix(). True value means keyboard's key pressed, False value means key not pressed.
+        BlockSynth keyboard;                    //all the keyboard's keys (a key for every row of the biggest level) and the "sequencer"'s column
+        BoardTripleBuffer boards;               //the Environment's board. An alive cell means keyboard's key pressed, a dead cell means key not pressed.
     
     
-        void setToPlayKeys(int indx);
         void setVerticalKeyboard(int size);
     
     public:
-        void setup(vector<vector<bool>> matrix);
+        void setup(int maxWidth, int maxHeight);
         void play(float *output, int bufferSize, int nChannels);
-        void setMatrix(vector<vector<bool>> matrix);
+        void setBoard(const BitBoard &board);
+        void setVoiceLimit(int limit);
         void SoundtrackClose();
     
 };
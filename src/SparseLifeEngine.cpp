@@ -0,0 +1,313 @@
+#include "SparseLifeEngine.hpp"
+#include "LifeKernel.hpp"
+#include <algorithm>
+#include <bitset>
+
+const int SparseLifeEngine::chunkSize;
+
+//the chunk coordinates (32 bits each, they can be negative) packed in one key
+uint64_t SparseLifeEngine::chunkKey(int64_t chunkX, int64_t chunkY){
+    return (uint64_t(uint32_t(chunkX)) << 32) | uint32_t(chunkY);
+}
+
+int64_t SparseLifeEngine::keyX(uint64_t key){
+    return int32_t(uint32_t(key >> 32));
+}
+
+int64_t SparseLifeEngine::keyY(uint64_t key){
+    return int32_t(uint32_t(key));
+}
+
+//the index of a chunk's row in the Zobrist hash (see BitBoard::wordKey())
+size_t SparseLifeEngine::rowIndex(uint64_t key, int y){
+    return size_t(key * chunkSize + y);
+}
+
+const SparseLifeEngine::Chunk *SparseLifeEngine::findChunk(int64_t chunkX, int64_t chunkY) const{
+    return chunks.find(chunkKey(chunkX, chunkY));
+}
+
+/*
+ it copies the level's words in the chunks: a chunk is as wide as a word, so the words are copied as they are.
+ The empty words don't create chunks.
+*/
+void SparseLifeEngine::load(const BitBoard &level){
+    chunks.clear();
+    nextChunks.clear();
+    width = level.getWidth();
+    height = level.getHeight();
+
+    for(int y=0; y<height; y++){
+        const uint64_t *row = level.getRow(y);
+        for(int i=0; i<level.getWordsPerRow(); i++){
+            if(row[i] != 0) chunks.insert(chunkKey(i, y / chunkSize)).rows[y % chunkSize] = row[i];   //a new chunk is all dead
+        }
+    }
+
+    stats = GenerationStats();
+    stats.population = level.countAlive();
+    for(size_t i=0; i<chunks.size(); i++){
+        for(int y=0; y<chunkSize; y++) stats.hash ^= BitBoard::wordKey(rowIndex(chunks.getKey(i), y), chunks.getChunk(i).rows[y]);
+    }
+}
+
+void SparseLifeEngine::setRule(const LifeRule &_rule){
+    rule = _rule;
+}
+
+/*
+ STEP
+
+ 1) the candidates are the stored chunks and the neighbours of their border cells (a new chunk can be born only near an alive cell)
+ 2) every candidate is computed in the next map, and only if it has alive cells it is stored
+ 3) the two maps are swapped (the old chunks are cleared at the next step, their memory is reused)
+
+ The rule's kernel is selected once for the whole generation.
+*/
+void SparseLifeEngine::step(){
+    candidates.clear();
+
+    for(size_t i=0; i<chunks.size(); i++){
+        const Chunk &chunk = chunks.getChunk(i);
+        int64_t chunkX = keyX(chunks.getKey(i));
+        int64_t chunkY = keyY(chunks.getKey(i));
+
+        uint64_t columns = 0;                   //the columns with at least one alive cell
+        for(int y=0; y<chunkSize; y++) columns |= chunk.rows[y];
+        bool edgeX[3] = {(columns & 1) != 0, true, (columns >> 63) != 0};                 //[dx + 1] => the left/right border has alive cells
+        bool edgeY[3] = {chunk.rows[0] != 0, true, chunk.rows[chunkSize-1] != 0};         //[dy + 1] => the top/bottom border has alive cells
+
+        for(int dy=-1; dy<=1; dy++){
+            for(int dx=-1; dx<=1; dx++){
+                if(edgeX[dx+1] && edgeY[dy+1]) candidates.push_back(chunkKey(chunkX + dx, chunkY + dy));
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    nextChunks.clear();
+    stats.births = 0;
+    stats.deaths = 0;
+    LifeKernel::selectRule(rule, [&](const auto &kernelRule){
+        Chunk next;
+        for(uint64_t key : candidates){
+            const Chunk *current = findChunk(keyX(key), keyY(key));
+            bool alive = nextChunk(key, next, kernelRule);
+
+            for(int y=0; y<chunkSize; y++){
+                uint64_t prevRow = current ? current->rows[y] : 0;
+                if(prevRow == next.rows[y]) continue;
+                stats.births += std::bitset<64>(next.rows[y] & ~prevRow).count();
+                stats.deaths += std::bitset<64>(prevRow & ~next.rows[y]).count();
+                stats.hash ^= BitBoard::wordKey(rowIndex(key, y), prevRow) ^ BitBoard::wordKey(rowIndex(key, y), next.rows[y]);
+            }
+            if(alive) nextChunks.insert(key) = next;
+        }
+    });
+
+    chunks.swap(nextChunks);
+    stats.population += stats.births - stats.deaths;
+    stats.addedCells = 0;
+    stats.removedCells = 0;
+    stats.generation++;
+}
+
+/*
+ NEXTCHUNK
+
+ The rows of the 3 columns of chunks around the chunk (left, center, right) are copied with one more row on the top and on the bottom (the missing chunks are dead).
+ Then every row is computed with the LifeKernel: the left and right neighbours of the chunk's border cells are the bits of the left and right columns.
+*/
+template<class Rule>
+bool SparseLifeEngine::nextChunk(uint64_t key, Chunk &next, const Rule &kernelRule) const{
+    int64_t chunkX = keyX(key);
+    int64_t chunkY = keyY(key);
+    uint64_t columns[3][chunkSize + 2];         //[dx + 1][y + 1]
+
+    for(int dx=-1; dx<=1; dx++){
+        const Chunk *up = findChunk(chunkX + dx, chunkY - 1);
+        const Chunk *middle = findChunk(chunkX + dx, chunkY);
+        const Chunk *down = findChunk(chunkX + dx, chunkY + 1);
+        uint64_t *column = columns[dx+1];
+
+        column[0] = up ? up->rows[chunkSize-1] : 0;
+        for(int y=0; y<chunkSize; y++) column[y+1] = middle ? middle->rows[y] : 0;
+        column[chunkSize+1] = down ? down->rows[0] : 0;
+    }
+
+    uint64_t anyAlive = 0;
+    for(int y=0; y<chunkSize; y++){
+        uint64_t left[3], center[3], right[3];
+
+        for(int r=0; r<3; r++){
+            center[r] = columns[1][y+r];
+            left[r] = (center[r] << 1) | (columns[0][y+r] >> 63);          //the bit x contains the cell x-1
+            right[r] = (center[r] >> 1) | (columns[2][y+r] << 63);         //the bit x contains the cell x+1
+        }
+        next.rows[y] = LifeKernel::nextCells(left, center, right, kernelRule);
+        anyAlive |= next.rows[y];
+    }
+    return anyAlive != 0;
+}
+
+bool SparseLifeEngine::get(int x, int y) const{
+    const Chunk *chunk = findChunk(x >> 6, y >> 6);               //floor(x / 64), also for the negative coordinates
+    return chunk && ((chunk->rows[y & 63] >> (x & 63)) & 1);
+}
+
+//a chunk is created when its first cell is set alive, and deleted when its last cell is killed
+void SparseLifeEngine::set(int x, int y, bool alive){
+    if(get(x, y) == alive) return;
+
+    uint64_t key = chunkKey(x >> 6, y >> 6);
+    uint64_t bit = uint64_t(1) << (x & 63);
+    const Chunk *current = findChunk(x >> 6, y >> 6);
+    uint64_t prevRow = current ? current->rows[y & 63] : 0;
+    stats.hash ^= BitBoard::wordKey(rowIndex(key, y & 63), prevRow) ^ BitBoard::wordKey(rowIndex(key, y & 63), prevRow ^ bit);
+    
+    if(alive){
+        chunks.insert(key).rows[y & 63] |= bit;
+        stats.population++;
+        stats.addedCells++;
+    }
+    else{
+        Chunk &chunk = chunks.insert(key);
+        chunk.rows[y & 63] &= ~bit;
+        stats.population--;
+        stats.removedCells++;
+
+        uint64_t anyAlive = 0;
+        for(int row=0; row<chunkSize; row++) anyAlive |= chunk.rows[row];
+        if(anyAlive == 0) chunks.erase(key);
+    }
+}
+
+long SparseLifeEngine::countAlive() const{
+    return stats.population;
+}
+
+//only the chunks inside the level's area are written (the cells outside the area are not lost, they are only not visible)
+void SparseLifeEngine::copyTo(BitBoard &board) const{
+    board.resize(width, height);
+    int wordsPerRow = board.getWordsPerRow();
+    uint64_t lastWordMask = (width % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (width % 64)) - 1;
+
+    for(size_t i=0; i<chunks.size(); i++){
+        int64_t chunkX = keyX(chunks.getKey(i));
+        int64_t chunkY = keyY(chunks.getKey(i));
+        if(chunkX < 0 || chunkX >= wordsPerRow || chunkY < 0 || chunkY * chunkSize >= height) continue;
+
+        for(int y=0; y<chunkSize && chunkY * chunkSize + y < height; y++){
+            uint64_t word = chunks.getChunk(i).rows[y];
+            if(chunkX == wordsPerRow - 1) word &= lastWordMask;
+            board.getRow(int(chunkY * chunkSize + y))[chunkX] = word;
+        }
+    }
+}
+
+const GenerationStats &SparseLifeEngine::getStats() const{
+    return stats;
+}
+
+size_t SparseLifeEngine::getChunkCount() const{
+    return chunks.size();
+}
+
+//the allocated memory of the two maps (also the reused chunks)
+size_t SparseLifeEngine::getMemorySize() const{
+    return sizeof(SparseLifeEngine) + chunks.getMemorySize() + nextChunks.getMemorySize() + candidates.capacity() * sizeof(uint64_t);
+}
+
+/*
+ CHUNKMAP
+
+ The slot of a key is its hash (Fibonacci hashing of the key) and the following ones (linear probing). The slots are at most half full.
+ An erased slot is filled by the following keys of its probe sequence (backward shift), so there aren't tombstones.
+*/
+size_t SparseLifeEngine::ChunkMap::findSlot(uint64_t key) const{
+    size_t mask = slots.size() - 1;
+    size_t slot = size_t((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while(slots[slot] != 0 && keys[slots[slot] - 1] != key) slot = (slot + 1) & mask;
+    return slot;
+}
+
+void SparseLifeEngine::ChunkMap::grow(){
+    slots.assign(std::max<size_t>(16, slots.size() * 2), 0);
+    for(size_t i=0; i<keys.size(); i++) slots[findSlot(keys[i])] = uint32_t(i + 1);
+}
+
+const SparseLifeEngine::Chunk *SparseLifeEngine::ChunkMap::find(uint64_t key) const{
+    if(keys.empty()) return nullptr;
+    uint32_t index = slots[findSlot(key)];
+    return index == 0 ? nullptr : &chunks[index - 1];
+}
+
+//the dense arrays grow only when there are more chunks than ever before
+SparseLifeEngine::Chunk &SparseLifeEngine::ChunkMap::insert(uint64_t key){
+    if((keys.size() + 1) * 2 > slots.size()) grow();
+    size_t slot = findSlot(key);
+    if(slots[slot] == 0){
+        keys.push_back(key);
+        chunks.push_back(Chunk());                                  //all dead (value-initialized)
+        slots[slot] = uint32_t(keys.size());
+    }
+    return chunks[slots[slot] - 1];
+}
+
+void SparseLifeEngine::ChunkMap::erase(uint64_t key){
+    if(keys.empty()) return;
+    size_t mask = slots.size() - 1;
+    size_t slot = findSlot(key);
+    if(slots[slot] == 0) return;
+    size_t index = slots[slot] - 1;
+
+    //backward shift: a following key moves into the hole if its own slot is not between the hole and it
+    size_t hole = slot;
+    for(size_t next = (hole + 1) & mask; slots[next] != 0; next = (next + 1) & mask){
+        size_t home = size_t((keys[slots[next] - 1] * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+        if(((next - home) & mask) >= ((next - hole) & mask)){
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = 0;
+
+    //the last chunk of the dense arrays takes the erased chunk's place
+    size_t last = keys.size() - 1;
+    if(index != last){
+        slots[findSlot(keys[last])] = uint32_t(index + 1);
+        keys[index] = keys[last];
+        chunks[index] = chunks[last];
+    }
+    keys.pop_back();
+    chunks.pop_back();
+}
+
+void SparseLifeEngine::ChunkMap::clear(){
+    keys.clear();
+    chunks.clear();
+    std::fill(slots.begin(), slots.end(), 0);
+}
+
+size_t SparseLifeEngine::ChunkMap::size() const{
+    return keys.size();
+}
+
+uint64_t SparseLifeEngine::ChunkMap::getKey(size_t i) const{
+    return keys[i];
+}
+
+const SparseLifeEngine::Chunk &SparseLifeEngine::ChunkMap::getChunk(size_t i) const{
+    return chunks[i];
+}
+
+void SparseLifeEngine::ChunkMap::swap(ChunkMap &other){
+    keys.swap(other.keys);
+    chunks.swap(other.chunks);
+    slots.swap(other.slots);
+}
+
+size_t SparseLifeEngine::ChunkMap::getMemorySize() const{
+    return keys.capacity() * sizeof(uint64_t) + chunks.capacity() * sizeof(Chunk) + slots.capacity() * sizeof(uint32_t);
+}
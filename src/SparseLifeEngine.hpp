@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include "LifeBackend.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ SPARSELIFEENGINE
+ The SparseLifeEngine class is a LifeBackend for unbounded levels: the board is an infinite plane (there isn't the PACMAN effect), and the level is only its starting area [0, width) * [0, height).
+ The plane is split in chunks of 64 * 64 cells (64 rows of one 64-bit word, like a BitBoard's tile), stored in a hash map by their chunk coordinates.
+
+ Only the chunks with at least one alive cell are stored. In every generation only the stored chunks and the neighbour chunks touched by their border cells are computed, and the chunks that die are removed.
+ So the memory and the time of a generation depend on the alive cells, not on the area they cover: a glider can fly away forever and it always costs one or two chunks.
+ The population, the births, the deaths and the Zobrist hash are updated with the changed rows, like in the LifeEngine.
+ The chunks are stored in a ChunkMap: an open addressing hash table (linear probing) of indexes in a dense array of chunks. Its arrays are cleared but never freed, so after the first generations a step doesn't allocate anything (an unordered_map allocates a node for every chunk of every generation).
+
+ The methods are:
+
+ -load() => it copies the level in the chunks (the level's area is also the area written by copyTo())
+ -setRule() => it sets the rule (the kernel is selected once for every generation, see LifeKernel)
+ -step() => it computes the next generation of the active chunks
+ -get() => it returns the state of the cell (x, y), also outside the level's area
+ -set() => it sets the state of the cell (x, y), the chunk is created if needed
+ -countAlive() => it returns the alive cells of the whole plane (counted while the chunks are computed)
+ -copyTo() => it writes the level's area in a board
+ -getStats() => it returns the stats of the last generation (population, births, deaths)
+ -getChunkCount() => it returns the number of stored chunks
+ -getMemorySize() => it returns the bytes used by the chunks (approximately, for the hash maps)
+ -nextChunk() => (private) it computes the next generation of a chunk, it returns false if the chunk is empty
+
+ The ChunkMap's methods are:
+
+ -find() => it returns the chunk of a key, or nullptr
+ -insert() => it returns the chunk of a key, a new chunk (all dead) is added if needed
+ -erase() => it removes the chunk of a key (the last chunk takes its place in the dense array)
+ -clear() => it removes all the chunks, the memory is kept
+ -size() => it returns the number of chunks
+ -getKey(), getChunk() => they return the key and the chunk at an index of the dense array (the iteration)
+ -swap() => it swaps the contents of two maps (without copies)
+ -getMemorySize() => it returns the bytes allocated by the map
+ -findSlot() => (private) it returns the slot of a key, or the empty slot where it would be inserted
+ -grow() => (private) it doubles the slots and inserts the keys again
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class SparseLifeEngine : public LifeBackend{
+
+    private:
+        static const int chunkSize = 64;        //a chunk is chunkSize * chunkSize cells (chunkSize rows of one word)
+
+        struct Chunk{
+            uint64_t rows[chunkSize];           //the bit x of the row y is the cell (chunkX * 64 + x, chunkY * 64 + y)
+        };
+
+        class ChunkMap{
+            private:
+                std::vector<uint64_t> keys;     //dense: keys[i] is the key of chunks[i]
+                std::vector<Chunk> chunks;
+                std::vector<uint32_t> slots;    //a power of 2 number of slots: index + 1 in the dense arrays (0 => empty)
+
+                size_t findSlot(uint64_t key) const;
+                void grow();
+
+            public:
+                const Chunk *find(uint64_t key) const;
+                Chunk &insert(uint64_t key);
+                void erase(uint64_t key);
+                void clear();
+                size_t size() const;
+                uint64_t getKey(size_t i) const;
+                const Chunk &getChunk(size_t i) const;
+                void swap(ChunkMap &other);
+                size_t getMemorySize() const;
+        };
+
+        ChunkMap chunks;                        //the chunks of the current generation (only the non empty ones)
+        ChunkMap nextChunks;                    //the generation that is being computed
+        std::vector<uint64_t> candidates;       //the chunks to compute in the next generation (reused)
+        LifeRule rule;
+        int width = 0;
+        int height = 0;
+        GenerationStats stats;
+
+        static uint64_t chunkKey(int64_t chunkX, int64_t chunkY);
+        static int64_t keyX(uint64_t key);
+        static int64_t keyY(uint64_t key);
+        static size_t rowIndex(uint64_t key, int y);
+        const Chunk *findChunk(int64_t chunkX, int64_t chunkY) const;
+        template<class Rule> bool nextChunk(uint64_t key, Chunk &next, const Rule &kernelRule) const;
+
+    public:
+        void load(const BitBoard &level) override;
+        void setRule(const LifeRule &_rule) override;
+        void step() override;
+        bool get(int x, int y) const override;
+        void set(int x, int y, bool alive) override;
+        long countAlive() const override;
+        void copyTo(BitBoard &board) const override;
+        const GenerationStats &getStats() const;
+        size_t getChunkCount() const;
+        size_t getMemorySize() const;
+
+};
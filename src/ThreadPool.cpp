@@ -0,0 +1,132 @@
+#include "ThreadPool.hpp"
+
+/*
+ THREADPOOL contructor
+
+ The threads are created only here: a job doesn't create threads.
+*/
+ThreadPool::ThreadPool(int _threadCount){
+    threadCount = _threadCount > 0 ? _threadCount : std::max(1, int(std::thread::hardware_concurrency()));
+    ranges.reset(new TaskRange[threadCount]);
+    for(int t=0; t<threadCount; t++) ranges[t].range = 0;
+
+    for(int t=1; t<threadCount; t++){
+        threads.push_back(std::thread(&ThreadPool::workerLoop, this, t));
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobCondition.notify_all();
+    for(std::thread &thread : threads) thread.join();
+}
+
+int ThreadPool::getThreadCount() const{
+    return threadCount;
+}
+
+/*
+ RUN
+
+ The tasks are split in contiguous ranges (one for each thread), then the workers are woken up and the calling thread works too.
+ It returns only when every worker finished the job, so a late worker can't take a task of the next job with the old function.
+*/
+void ThreadPool::run(int count, void *context, void (*function)(void *, int)){
+    if(threadCount == 1){
+        for(int i=0; i<count; i++) function(context, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(int t=0; t<threadCount; t++){
+            uint64_t first = uint64_t(count) * t / threadCount;
+            uint64_t end = uint64_t(count) * (t + 1) / threadCount;
+            ranges[t].range = (first << 32) | end;
+        }
+        jobContext = context;
+        jobFunction = function;
+        finishedWorkers = 0;
+        jobId++;
+    }
+    jobCondition.notify_all();
+
+    runTasks(0, context, function);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this]{ return finishedWorkers == threadCount - 1; });
+}
+
+void ThreadPool::workerLoop(int threadIndex){
+    long seenJobId = 0;
+
+    while(true){
+        void *context;
+        void (*function)(void *, int);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobCondition.wait(lock, [&]{ return stopping || jobId != seenJobId; });
+            if(stopping) return;
+
+            seenJobId = jobId;
+            context = jobContext;
+            function = jobFunction;
+        }
+
+        runTasks(threadIndex, context, function);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishedWorkers++;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+//first the thread's own tasks, then the stolen ones
+void ThreadPool::runTasks(int threadIndex, void *context, void (*function)(void *, int)){
+    int task;
+    while(takeTask(threadIndex, task) || stealTask(threadIndex, task)){
+        function(context, task);
+    }
+}
+
+//it takes the first task of the thread's range
+bool ThreadPool::takeTask(int threadIndex, int &task){
+    std::atomic<uint64_t> &range = ranges[threadIndex].range;
+    uint64_t current = range.load();
+
+    while(true){
+        uint64_t first = current >> 32;
+        uint64_t end = current & 0xFFFFFFFF;
+        if(first >= end) return false;
+
+        if(range.compare_exchange_weak(current, ((first + 1) << 32) | end)){
+            task = first;
+            return true;
+        }
+    }
+}
+
+//it steals the last task of another thread's range
+bool ThreadPool::stealTask(int threadIndex, int &task){
+    for(int t=1; t<threadCount; t++){
+        std::atomic<uint64_t> &range = ranges[(threadIndex + t) % threadCount].range;
+        uint64_t current = range.load();
+
+        while(true){
+            uint64_t first = current >> 32;
+            uint64_t end = current & 0xFFFFFFFF;
+            if(first >= end) break;
+
+            if(range.compare_exchange_weak(current, (first << 32) | (end - 1))){
+                task = end - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ THREADPOOL
+ The ThreadPool class runs a "parallel for" (n tasks, identified by their index) on a group of persistent threads. The threads are created once, and between two jobs they sleep.
+ The calling thread works too, so a pool of n threads creates only n-1 threads.
+
+ Work stealing: at the beginning of a job, every thread receives a contiguous range of tasks. It takes its tasks from the front of its range, and when its range is empty it steals tasks from the back of the other threads' ranges.
+ A range is a single atomic word (first task, last task), so taking or stealing a task is a compare-and-swap, without locks and without allocations.
+
+ The methods are:
+
+ -ThreadPool() => it creates the threads (0 => one thread for each CPU core)
+ -~ThreadPool() => it stops and joins the threads
+ -parallelFor() => it runs func(i) for every i in [0, count) and returns when all the tasks are completed
+ -getThreadCount() => it returns the number of threads (the calling thread included)
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class ThreadPool{
+
+    private:
+        struct TaskRange{
+            std::atomic<uint64_t> range;        //first task (high 32 bits) and end (low 32 bits)
+        };
+
+        std::vector<std::thread> threads;
+        std::unique_ptr<TaskRange[]> ranges;    //one range for each thread (index 0 is the calling thread)
+        int threadCount;
+
+        std::mutex mutex;
+        std::condition_variable jobCondition;   //the workers wait for a new job
+        std::condition_variable doneCondition;  //the calling thread waits for the workers
+        long jobId = 0;
+        int finishedWorkers = 0;
+        bool stopping = false;
+
+        void *jobContext;
+        void (*jobFunction)(void *context, int index);
+
+        void workerLoop(int threadIndex);
+        void runTasks(int threadIndex, void *context, void (*function)(void *, int));
+        bool takeTask(int threadIndex, int &task);
+        bool stealTask(int threadIndex, int &task);
+        void run(int count, void *context, void (*function)(void *, int));
+
+    public:
+        ThreadPool(int _threadCount = 0);
+        ~ThreadPool();
+        int getThreadCount() const;
+
+        //func can be any callable (a lambda with captures too): it is passed as a pointer, so nothing is allocated
+        template<class Function>
+        void parallelFor(int count, Function &func){
+            run(count, &func, [](void *context, int index){
+                (*static_cast<Function *>(context))(index);
+            });
+        }
+
+};
@@ -0,0 +1,105 @@
+#include "Tracer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+const size_t Tracer::bufferSize;
+std::atomic<bool> Tracer::enabled(false);
+std::mutex Tracer::buffersMutex;
+std::vector<std::unique_ptr<Tracer::ThreadBuffer>> Tracer::buffers;
+
+void Tracer::setEnabled(bool _enabled){
+    enabled.store(_enabled, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled(){
+    return enabled.load(std::memory_order_relaxed);
+}
+
+//the name is written with the lock, because the dump can read it from another thread
+void Tracer::setThreadName(const std::string &name){
+    ThreadBuffer &buffer = getThreadBuffer();
+    if(buffer.threadName == name) return;
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffer.threadName = name;
+}
+
+//the microseconds since the first call (the same clock for all the threads)
+double Tracer::now(){
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+Tracer::ThreadBuffer &Tracer::getThreadBuffer(){
+    thread_local ThreadBuffer *threadBuffer = nullptr;
+    if(threadBuffer) return *threadBuffer;
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.emplace_back(new ThreadBuffer());
+    threadBuffer = buffers.back().get();
+    threadBuffer->events.resize(bufferSize);
+    threadBuffer->threadId = int(buffers.size());
+    threadBuffer->threadName = "thread " + std::to_string(buffers.size());             //see setThreadName()
+    return *threadBuffer;
+}
+
+//the event is written first, then it is published by the head's release store (the dump reads the head with an acquire load)
+void Tracer::record(const char *name, double start, double end){
+    ThreadBuffer &buffer = getThreadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+    Event &event = buffer.events[head % bufferSize];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+/*
+ DUMP
+
+ The threads continue to record while their buffers are copied: after the copy the head is read again, and the events that the owner thread could have overwritten in the meantime are discarded.
+ Only the events that ended in the last "seconds" seconds are written, sorted by start time.
+*/
+bool Tracer::dump(const std::string &path, double seconds){
+    double from = now() - seconds * 1e6;
+    std::vector<std::pair<int, Event>> events;                      //thread id, event
+    std::vector<std::pair<int, std::string>> threads;
+
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        std::vector<Event> copy(bufferSize);
+
+        for(const std::unique_ptr<ThreadBuffer> &buffer : buffers){
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t first = head > bufferSize ? head - bufferSize : 0;
+            for(uint64_t i=first; i<head; i++) copy[i % bufferSize] = buffer->events[i % bufferSize];
+
+            uint64_t newHead = buffer->head.load(std::memory_order_acquire);
+            if(newHead >= bufferSize) first = std::max(first, newHead - bufferSize + 1);       //the slot newHead % bufferSize can be being written
+
+            for(uint64_t i=first; i<head; i++){
+                const Event &event = copy[i % bufferSize];
+                if(event.start + event.duration >= from) events.push_back({buffer->threadId, event});
+            }
+            threads.push_back({buffer->threadId, buffer->threadName});
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const std::pair<int, Event> &a, const std::pair<int, Event> &b){ return a.second.start < b.second.start; });
+
+    FILE *file = std::fopen(path.c_str(), "w");
+    if(!file) return false;
+
+    std::fprintf(file, "{\"traceEvents\": [\n");
+    for(const std::pair<int, std::string> &thread : threads){
+        std::fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}},\n", thread.first, thread.second.c_str());
+    }
+    for(const std::pair<int, Event> &event : events){
+        std::fprintf(file, "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f},\n",
+                     event.second.name, event.first, event.second.start, event.second.duration);
+    }
+    std::fprintf(file, "{\"name\": \"dump\", \"ph\": \"i\", \"s\": \"g\", \"pid\": 1, \"tid\": 1, \"ts\": %.3f}\n]}\n", now());      //the last event has no comma
+    std::fclose(file);
+    return true;
+}
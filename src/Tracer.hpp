@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ TRACER
+ The Tracer class records how long the phases of every frame take (update, generation step, soundtrack's matrix, draw, GUI, audio callback), to find the cause of a frame's hitch.
+ The simulation's classes are traced too.
+
+ A phase is measured by a Tracer::Scope object: it reads the clock when it is created and records the event when it is destroyed (at the end of the block).
+    Tracer::Scope trace("Environment::update");
+ When the tracer is disabled (the default), a Scope only reads an atomic flag: the overhead is close to zero.
+
+ Every thread records its events in its own ring buffer (the last bufferSize events), so the recording doesn't lock anything: only the owner thread writes its buffer, and it publishes the new events with an atomic counter.
+ The buffers are registered (with a lock) the first time a thread records an event, and they are never deleted (a dump can read the events of a thread that has finished).
+
+ The dump writes the events of the last n seconds in the chrome://tracing JSON format (complete "X" events, one row for every thread).
+
+ The methods are:
+
+ -setEnabled() => it starts/stops the recording
+ -isEnabled() => it returns true if the events are recorded
+ -setThreadName() => it sets the name of the calling thread's row in the trace (e.g. "audio")
+ -dump() => it writes the events of the last n seconds in a JSON file, it returns false if the file can't be written
+ -now() => it returns the tracer's clock (microseconds)
+ -getThreadBuffer() => (private) it returns the ring buffer of the calling thread (it is created and registered the first time)
+ -record() => (private) it writes an event in the calling thread's ring buffer
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+class Tracer{
+
+    public:
+        struct Event{
+            const char *name;                   //a string literal (it is not copied)
+            double start;                       //microseconds
+            double duration;
+        };
+
+        class Scope{
+            private:
+                const char *name;
+                double start;
+                bool active;
+
+            public:
+                //inline: a disabled scope costs one relaxed load and one branch
+                Scope(const char *_name) : name(_name), start(0), active(enabled.load(std::memory_order_relaxed)){
+                    if(active) start = now();
+                }
+                //the event is recorded also if the tracer has been disabled in the meantime (the scope started while it was enabled)
+                ~Scope(){
+                    if(active) record(name, start, now());
+                }
+        };
+
+        static void setEnabled(bool _enabled);
+        static bool isEnabled();
+        static void setThreadName(const std::string &name);
+        static bool dump(const std::string &path, double seconds);
+        static double now();
+
+    private:
+        static const size_t bufferSize = 16384;     //events of every thread's ring buffer
+
+        struct ThreadBuffer{
+            std::vector<Event> events;
+            std::atomic<uint64_t> head{0};          //events written since the beginning (the next position is head % bufferSize)
+            int threadId;
+            std::string threadName;
+        };
+
+        static std::atomic<bool> enabled;
+        static std::mutex buffersMutex;                                 //only for the registration of a new thread and for the dump
+        static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+        static ThreadBuffer &getThreadBuffer();
+        static void record(const char *name, double start, double end);
+
+};
@@ -9,7 +9,7 @@ void ofApp::setup(){
     ofSetVerticalSync(true);    //Avoid tearing
     //ofEnableLighting();
 
-    game.setup();
+    game.setup(sampleRate);                           //the audio monitor measures the callbacks against the stream's buffer period
     
     // the cam is positioned z in "vertical" and y "backwards" (farther in space => z negative values)
     int gameSize = game.getGameSize();
@@ -24,11 +24,12 @@ void ofApp::setup(){
     
     
     //enable the audio stream. Params are: out channels, in channels, s.r., b.s., and number of buffers to queue.
-    ofSoundStreamSetup(2, 0, this, sampleRate, bufferSize, 4);
+    ofSoundStreamSetup(2, 0, this, sampleRate, bufferSize, queuedBuffers);
     
 }
 
 void ofApp::update(){
+    Tracer::Scope trace("ofApp::update");
     
     //the cam and light position is constantly setted because levels could have different sizes
     int gameSize = game.getGameSize();
@@ -40,6 +41,8 @@ void ofApp::update(){
 }
 
 void ofApp::draw(){
+    Tracer::Scope trace("ofApp::draw");
+    
     /*
     the GUI should be drawn outside the cam POV, the setted lights and the 3D perspective (the last because the gui's labels don't work with the depthTest enabled)
     */
@@ -59,6 +62,8 @@ void ofApp::draw(){
 }
 
 void ofApp::audioOut( float * output, int bufferSize, int nChannels ) {
+    if(Tracer::isEnabled()) Tracer::setThreadName("audio");     //the audio thread's buffer is created only if the tracer is used
+    Tracer::Scope trace("ofApp::audioOut");
     game.audioOut(output, bufferSize, nChannels);
     
 }
@@ -50,6 +50,7 @@ class ofApp : public ofBaseApp{
          + buffersize = - calls to the audio hardware, but + delay
         */
         const int bufferSize = 512;
+        const int queuedBuffers = 4;    //the buffers queued by the sound device (more buffers => fewer underruns, but + delay)
         const int frameRate = 60;       // fps
     
 	public:
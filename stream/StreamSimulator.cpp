@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LevelParser.hpp"
+#include "LifeEngine.hpp"
+#include "SparseLifeEngine.hpp"
+#include "BlockSynth.hpp"
+#include "BoardTripleBuffer.hpp"
+#include "AudioMonitor.hpp"
+#include "SimulatedStream.hpp"
+
+/*--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**
+
+ STREAMSIMULATOR
+ The stream simulator is a command line program that plays a level's soundtrack in real time on a SimulatedStream (a sound stream without a sound device), and measures every callback with the game's AudioMonitor.
+ It is the game's audio path without openFrameworks:
+    -the main thread is the game's loop => a frame every 1/frameRate seconds, a generation every delay frames, the new board is passed to the audio thread with a BoardTripleBuffer, and the spikes are read and printed (like Game::update())
+    -the stream's thread is Game::audioOut() => an AudioMonitor::Scope around the Soundtrack's keyboard (BlockSynth::setupKeyboard())
+
+ A slow machine or a slow callback can be simulated: -L adds a busy wait to every callback, -S and -P add a longer busy wait every n callbacks (a spike).
+ The program checks the measure: every injected spike longer than the buffer's deadline must be counted as an overrun and read as a spike. It prints the spikes, the monitor's report and the device's underruns (the gaps the listener would hear):
+
+    spike callback=799 time=9.277 us=17438.2 load=150%
+    level=0 size=5x5 seconds=10.0 rate=44100 buffer=512 queue=4 deadline_us=11610 callbacks=863 generations=2 injected=8 underruns=0 detected=yes
+    callbacks=863 overruns=8 deadline_us=11610 mean_us=177.3 worst_us=17459.4 worst_load=150% worst_callback=599 worst_interval_us=17460 spikes=8 histogram=0-10%:855,150-200%:8
+
+ Usage:
+
+    bacteria-stream [levels.txt] [-l level] [-s seconds] [-r sampleRate] [-b bufferSize] [-q queuedBuffers] [-L microseconds] [-S every] [-P microseconds]
+
+    -levels.txt => the levels file (bin/data/levels.txt by default)
+    -l => the level (0 by default)
+    -s => the seconds of streaming (10 by default)
+    -r => the sample rate (44100 by default)
+    -b => the frames of every audio buffer (512 by default)
+    -q => the buffers queued by the device (4 by default)
+    -L => the microseconds of busy wait added to every callback (0 by default)
+    -S => a spike every n callbacks (0 by default => no spikes)
+    -P => the microseconds of a spike (1.5 deadlines by default)
+
+ It returns 1 if an injected overrun isn't detected.
+ It has no build files of its own: its g++ line is in the README (Building the tools).
+
+ The functions are:
+
+ -main() => it reads the arguments and the level, then it runs the game's loop while the stream plays
+ -busyWait() => it keeps the CPU busy for some microseconds (a slow callback)
+ -printSpikes() => it prints the spikes not read yet
+
+ --**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--**--***/
+
+
+struct StreamOptions{
+    std::string path = "bin/data/levels.txt";
+    int level = 0;
+    double seconds = 10;
+    int sampleRate = 44100;                     //ofApp::sampleRate
+    int bufferSize = 512;                       //ofApp::bufferSize
+    int queuedBuffers = 4;                      //ofApp::queuedBuffers
+    int frameRate = 60;                         //ofApp::frameRate
+    double load = 0;                            //microseconds added to every callback
+    int spikeEvery = 0;
+    double spikeLength = 0;                     //0 => 1.5 deadlines
+    KeyboardOptions keyboard;
+};
+
+
+//it doesn't sleep: a sleeping callback would leave the CPU to the other threads, a slow one doesn't
+static void busyWait(double microseconds){
+    if(microseconds <= 0) return;
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::micro>(microseconds));
+    while(std::chrono::steady_clock::now() < end){}
+}
+
+static long printSpikes(AudioMonitor &monitor){
+    long count = 0;
+    AudioMonitor::Spike spike;
+    while(monitor.readSpike(spike)){
+        std::printf("spike callback=%ld time=%.3f us=%.1f load=%.0f%%\n", spike.callback, spike.time, spike.duration, spike.load * 100);
+        count++;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]){
+    StreamOptions options;
+
+    for(int i=1; i<argc; i++){
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "-l") == 0 && hasValue) options.level = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-s") == 0 && hasValue) options.seconds = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "-r") == 0 && hasValue) options.sampleRate = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-b") == 0 && hasValue) options.bufferSize = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-q") == 0 && hasValue) options.queuedBuffers = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-L") == 0 && hasValue) options.load = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "-S") == 0 && hasValue) options.spikeEvery = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "-P") == 0 && hasValue) options.spikeLength = std::atof(argv[++i]);
+        else if(argv[i][0] != '-') options.path = argv[i];
+        else{
+            options.sampleRate = 0;
+            break;
+        }
+    }
+    if(options.sampleRate <= 0 || options.bufferSize <= 0 || options.queuedBuffers <= 0 || options.seconds < 0 || options.load < 0 || options.spikeEvery < 0 || options.spikeLength < 0){
+        std::fprintf(stderr, "usage: %s [levels.txt] [-l level] [-s seconds] [-r sampleRate] [-b bufferSize] [-q queuedBuffers] [-L microseconds] [-S every] [-P microseconds]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<LevelParser::Level> levels;
+    if(!LevelParser::parseFile(options.path, levels)){
+        std::fprintf(stderr, "The file %s can't be read\n", options.path.c_str());
+        return 1;
+    }
+    if(options.level < 0 || options.level >= int(levels.size())){
+        std::fprintf(stderr, "The file has only %zu levels\n", levels.size());
+        return 1;
+    }
+    const LevelParser::Level &level = levels[options.level];
+    std::string error = LevelParser::check(level.board);           //the same checks of Game::levelChecker()
+    if(!error.empty()){
+        std::fprintf(stderr, "level %d: %s\n", options.level, error.c_str());
+        return 1;
+    }
+
+    LifeEngine lifeEngine;
+    SparseLifeEngine sparseEngine;
+    LifeBackend &engine = level.plane ? static_cast<LifeBackend &>(sparseEngine) : static_cast<LifeBackend &>(lifeEngine);
+    engine.load(level.board);
+    engine.setRule(level.rule);
+    BitBoard board = level.board;
+
+    //everything the audio thread uses is allocated before the stream starts (like Game::setup())
+    BoardTripleBuffer boards;
+    boards.reserve(board.getWidth(), board.getHeight());
+    boards.write(board);
+    BlockSynth synth;
+    synth.setupKeyboard(options.sampleRate, board.getHeight(), options.keyboard);
+    AudioMonitor monitor(options.sampleRate);
+
+    const double deadline = options.bufferSize * 1e6 / options.sampleRate;
+    const double spikeLength = options.spikeLength > 0 ? options.spikeLength : deadline * 1.5;
+    std::atomic<long> injected{0};                                  //the spikes longer than the deadline
+    long callback = 0;                                              //only the stream's thread uses it
+
+    SimulatedStream stream;
+    stream.start(options.sampleRate, options.bufferSize, 2, options.queuedBuffers, [&](float *output, int bufferSize, int nChannels){
+        AudioMonitor::Scope measure(monitor, bufferSize);
+        boards.read();
+        synth.render(boards.getBoard(), output, bufferSize, nChannels);
+        busyWait(options.load);
+        if(options.spikeEvery > 0 && ++callback % options.spikeEvery == 0){
+            busyWait(spikeLength);
+            if(spikeLength > deadline) injected.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    //the game's loop: a generation every delay frames
+    const auto framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / options.frameRate));
+    const long totalFrames = long(options.seconds * options.frameRate);
+    auto nextFrame = std::chrono::steady_clock::now();
+    long generations = 0, spikes = 0;
+    for(long frame=1; frame<=totalFrames; frame++){
+        nextFrame += framePeriod;
+        std::this_thread::sleep_until(nextFrame);
+        if(frame % std::max(level.delay, 1) == 0){
+            engine.step();
+            engine.copyTo(board);
+            boards.write(board);
+            generations++;
+        }
+        spikes += printSpikes(monitor);
+    }
+    stream.stop();
+    spikes += printSpikes(monitor);
+
+    AudioMonitor::Report report = monitor.getReport();
+    long injectedSpikes = injected.load();
+    bool detected = report.overruns >= injectedSpikes && spikes >= injectedSpikes;
+    std::printf("level=%d size=%dx%d seconds=%.1f rate=%d buffer=%d queue=%d deadline_us=%.0f callbacks=%ld generations=%ld injected=%ld underruns=%ld detected=%s\n",
+                options.level, board.getWidth(), board.getHeight(), options.seconds, options.sampleRate, options.bufferSize, options.queuedBuffers,
+                deadline, stream.getCallbacks(), generations, injectedSpikes, stream.getUnderruns(), detected ? "yes" : "no");
+    std::printf("%s\n", AudioMonitor::toString(report).c_str());
+    return detected ? 0 : 1;
+}